@@ -0,0 +1,90 @@
+/*
+	Demonstrates the asynchronous command engine.
+
+	Commands are queued and return immediately.  Calling "poll" from "loop" sends them to the chip and reads the answers, so the rest
+	of the loop keeps running while the audio chip works.  Here the built in LED keeps blinking while tracks are started and stopped.
+
+	Usage:
+	Enter a track number from the serial monitor to play it, or 'q' to stop playing.
+*/
+
+#include <SoftwareSerial.h>
+#include "VS1000UART.h"
+
+// Arduino pins that can be used with SoftwareSerial.
+#define ARDUINO_PIN_RX_FROM_AUDIO_TX	5
+#define ARDUINO_PIN_TX_TO_AUDIO_RX		6
+
+// Connect to the RST pin on the Sound Board.
+#define ARDUINO_PIN_FOR_AUDIO_RESET		4
+
+// We'll be using software serial.
+SoftwareSerial	_softwareSerial				= SoftwareSerial(ARDUINO_PIN_RX_FROM_AUDIO_TX, ARDUINO_PIN_TX_TO_AUDIO_RX);
+
+// Pass the software serial to the audio class and the reset pin.
+VS1000UART 		_vsUart 					= VS1000UART(&_softwareSerial, ARDUINO_PIN_FOR_AUDIO_RESET);
+
+// Called by the command engine each time a queued command finishes.
+void commandComplete(VS1000UART::COMMAND command, VS1000UART::COMMANDSTATUS status)
+{
+	Serial.print(F("Command "));
+	Serial.print(command);
+	if (status == VS1000UART::STATUSSUCCESS)
+	{
+		Serial.println(F(" succeeded."));
+	}
+	else
+	{
+		Serial.println(F(" failed."));
+	}
+}
+
+void setup()
+{
+	// Must call "begin" on serial stream before VS1000UART.
+	Serial.begin(115200);
+	_softwareSerial.begin(9600);
+	_vsUart.begin();
+
+	// The blocking functions still work and can be mixed with queued commands.
+	if (!_vsUart.reset())
+	{
+		Serial.println(F("VS1000 failed to reset."));
+
+		// Something went wrong, so we freeze.
+		while (1)
+		{
+		}
+	}
+
+	_vsUart.setCommandCallback(commandComplete);
+	pinMode(LED_BUILTIN, OUTPUT);
+
+	Serial.println(F("Audio ready."));
+}
+
+void loop()
+{
+	// Keeps the queued commands moving.  Returns right away.
+	_vsUart.poll();
+
+	// Other work that would have stalled while waiting on the chip.
+	digitalWrite(LED_BUILTIN, (millis() / 250) % 2);
+
+	if (Serial.available())
+	{
+		char characterRead = Serial.read();
+
+		if (isdigit(characterRead))
+		{
+			if (!_vsUart.queueCommand(VS1000UART::COMMANDPLAYNUMBER, characterRead - '0'))
+			{
+				Serial.println(F("Queue full."));
+			}
+		}
+		else if (characterRead == 'q')
+		{
+			_vsUart.queueCommand(VS1000UART::COMMANDSTOP);
+		}
+	}
+}
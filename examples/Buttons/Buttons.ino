@@ -0,0 +1,76 @@
+/*
+	Demonstrates binding buttons and a rotary encoder to the audio board.
+
+	The input layer reads and debounces the controls and queues what they do, so "loop" never waits on the chip.  Holding a volume
+	button repeats it, and turning the encoder quickly is merged into a single volume change by the command queue.
+
+	Wiring:
+	Buttons between the pins below and ground, no resistors are needed.  The encoder A and B outputs to pins 2 and 3, its common pin
+	to ground.
+*/
+
+#include <SoftwareSerial.h>
+#include "VS1000UART.h"
+#include "VS1000Input.h"
+
+// Arduino pins that can be used with SoftwareSerial.
+#define ARDUINO_PIN_RX_FROM_AUDIO_TX	5
+#define ARDUINO_PIN_TX_TO_AUDIO_RX		6
+
+// Connect to the RST pin on the Sound Board.
+#define ARDUINO_PIN_FOR_AUDIO_RESET		4
+
+// Buttons.
+#define ARDUINO_PIN_VOLUME_UP			7
+#define ARDUINO_PIN_VOLUME_DOWN			8
+#define ARDUINO_PIN_PLAY				9
+#define ARDUINO_PIN_STOP				10
+
+// Rotary encoder.
+#define ARDUINO_PIN_ENCODER_A			2
+#define ARDUINO_PIN_ENCODER_B			3
+
+// We'll be using software serial.
+SoftwareSerial	_softwareSerial				= SoftwareSerial(ARDUINO_PIN_RX_FROM_AUDIO_TX, ARDUINO_PIN_TX_TO_AUDIO_RX);
+
+// Pass the software serial to the audio class and the reset pin.
+VS1000UART 		_vsUart 					= VS1000UART(&_softwareSerial, ARDUINO_PIN_FOR_AUDIO_RESET);
+
+// The controls, which queue their actions on the audio class.
+VS1000Input		_input						= VS1000Input(&_vsUart);
+
+void setup()
+{
+	// Must call "begin" on serial stream before VS1000UART.
+	Serial.begin(115200);
+	_softwareSerial.begin(9600);
+	_vsUart.begin();
+
+	if (!_vsUart.reset())
+	{
+		Serial.println(F("VS1000 failed to reset."));
+
+		// Something went wrong, so we freeze.
+		while (1)
+		{
+		}
+	}
+
+	// The volume buttons repeat while held.  Play starts the first file.
+	_input.addButton(ARDUINO_PIN_VOLUME_UP, VS1000Input::ACTIONVOLUMELEVELUP, 0, true);
+	_input.addButton(ARDUINO_PIN_VOLUME_DOWN, VS1000Input::ACTIONVOLUMELEVELDOWN, 0, true);
+	_input.addButton(ARDUINO_PIN_PLAY, VS1000Input::ACTIONPLAYFILE, 0);
+	_input.addButton(ARDUINO_PIN_STOP, VS1000Input::ACTIONSTOP);
+
+	// Each click of the encoder is one volume level.
+	_input.addEncoder(ARDUINO_PIN_ENCODER_A, ARDUINO_PIN_ENCODER_B);
+
+	Serial.println(F("Audio ready."));
+}
+
+void loop()
+{
+	// Reads the controls and queues their actions, then the audio class sends them.  Neither waits.
+	_input.poll();
+	_vsUart.poll();
+}
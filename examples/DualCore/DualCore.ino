@@ -0,0 +1,105 @@
+/*
+	Demonstrates driving the audio board from its own task on a dual core ESP32 or RP2040, so the rest of the sketch never waits on
+	the chip.
+
+	On an ESP32, "start" runs the driver as a FreeRTOS task on core 1.  On an RP2040, "loop1" runs the driver on the second core.
+	"loop" only posts requests and reads the published volume, which never block.  It waits for a track to start to show how a
+	ticket is used.
+
+	Usage:
+	Connect the TX and RX of "Serial1" to RX and TX of the sound board.  Enter '+' or '-' from the serial monitor to change the volume
+	level, or a digit to play that track.
+
+	"VS1000PERSISTENCE" is off by default on these boards, since the EEPROMex library it uses only builds for AVR, so the volume
+	isn't saved.
+*/
+
+#if !defined(ARDUINO_ARCH_ESP32) && !defined(ARDUINO_ARCH_RP2040)
+	#error This example needs an ESP32 or RP2040.
+#endif
+
+#include "VS1000UART.h"
+#include "VS1000HardwareSerialTransport.h"
+#include "VS1000Task.h"
+
+// Connect to the RST pin on the Sound Board.
+#define ARDUINO_PIN_FOR_AUDIO_RESET		4
+
+// The transport connects the audio class to the hardware serial port.
+VS1000HardwareSerialTransport	_transport				= VS1000HardwareSerialTransport(&Serial1);
+
+// Pass the transport to the audio class and the reset pin.
+VS1000UART 						_vsUart 				= VS1000UART(&_transport, ARDUINO_PIN_FOR_AUDIO_RESET);
+
+// Owns the audio class once started.  Nothing else calls "_vsUart" after that.
+VS1000Task						_audioTask				= VS1000Task(&_vsUart);
+
+// Set once the board is ready, so the second core of an RP2040 waits for it.
+volatile bool					_audioReady				= false;
+
+void setup()
+{
+	Serial.begin(115200);
+
+	// Start the port through the transport so it can set up the port's buffers.  Must be done before VS1000UART.
+	_transport.begin(9600);
+	_vsUart.begin();
+
+	if (!_vsUart.reset())
+	{
+		Serial.println(F("VS1000 failed to reset."));
+
+		// Something went wrong, so we freeze.
+		while (1)
+		{
+		}
+	}
+
+	#if defined(ARDUINO_ARCH_ESP32)
+		_audioTask.start();
+	#endif
+	_audioReady = true;
+
+	Serial.println(F("Audio ready."));
+}
+
+void loop()
+{
+	if (!Serial.available())
+	{
+		return;
+	}
+
+	char characterRead = Serial.read();
+	if (characterRead == '+')
+	{
+		_audioTask.postVolumeLevel((VS1000UART::VOLUMELEVEL)(_audioTask.getVolumeLevel() + 1));
+	}
+	else if (characterRead == '-' && _audioTask.getVolumeLevel() > VS1000UART::VOLUME0)
+	{
+		_audioTask.postVolumeLevel((VS1000UART::VOLUMELEVEL)(_audioTask.getVolumeLevel() - 1));
+	}
+	else if (characterRead >= '0' && characterRead <= '9')
+	{
+		// Only this task sleeps while waiting, the driver goes on.
+		uint16_t ticket = _audioTask.post(VS1000UART::COMMANDPLAYNUMBER, characterRead - '0');
+		if (_audioTask.wait(ticket, 1000) == VS1000UART::STATUSSUCCESS)
+		{
+			Serial.println(F("Playing."));
+		}
+		else
+		{
+			Serial.println(F("Couldn't play that track."));
+		}
+	}
+}
+
+#if defined(ARDUINO_ARCH_RP2040)
+void loop1()
+{
+	if (_audioReady)
+	{
+		_audioTask.service();
+	}
+}
+#endif
@@ -0,0 +1,66 @@
+/*
+	Demonstrates connecting to the audio chip with a hardware serial port instead of SoftwareSerial.
+
+	Boards with a second hardware serial port (Mega, Leonardo, ESP32, RP2040, SAMD boards) can use it for the chip.  The port sends from
+	its own buffer, so commands don't stall the sketch while bytes go out and interrupts stay on.
+
+	Usage:
+	Connect the TX and RX of "Serial1" to RX and TX of the sound board.  Each time enter is pressed, the next track is played.
+*/
+
+#include "VS1000UART.h"
+#include "VS1000HardwareSerialTransport.h"
+
+// Connect to the RST pin on the Sound Board.
+#define ARDUINO_PIN_FOR_AUDIO_RESET		4
+
+// The transport connects the audio class to the hardware serial port.
+VS1000HardwareSerialTransport	_transport				= VS1000HardwareSerialTransport(&Serial1);
+
+// Pass the transport to the audio class and the reset pin.
+VS1000UART 						_vsUart 				= VS1000UART(&_transport, ARDUINO_PIN_FOR_AUDIO_RESET);
+
+uint8_t							_fileNumber				= 0;
+
+void setup()
+{
+	Serial.begin(115200);
+
+	// Start the port through the transport so it can set up the port's buffers.  Must be done before VS1000UART.
+	_transport.begin(9600);
+	_vsUart.begin();
+
+	if (!_vsUart.reset())
+	{
+		Serial.println(F("VS1000 failed to reset."));
+
+		// Something went wrong, so we freeze.
+		while (1)
+		{
+		}
+	}
+
+	Serial.println(F("Audio ready."));
+}
+
+void loop()
+{
+	if (Serial.available())
+	{
+		// Read all remaining data on the serial.
+		while (Serial.available())
+		{
+			Serial.read();
+		}
+
+		Serial.print(F("Playing track #"));
+		Serial.println(_fileNumber);
+		if (!_vsUart.playFile(_fileNumber))
+		{
+			// Past the last track, start over.
+			_fileNumber = 0;
+			_vsUart.playFile(_fileNumber);
+		}
+		_fileNumber++;
+	}
+}
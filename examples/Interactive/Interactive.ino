@@ -39,6 +39,10 @@
 #include <SoftwareSerial.h>
 #include "VS1000UART.h"
 
+#if !VS1000LISTING || !VS1000PLAYBYNAME || !VS1000PROGRESS
+	#error This example needs VS1000LISTING, VS1000PLAYBYNAME, and VS1000PROGRESS.
+#endif
+
 // Arduino pins that can be used with SoftwareSerial.
 #define ARDUINO_PIN_RX_FROM_AUDIO_TX	5
 #define ARDUINO_PIN_TX_TO_AUDIO_RX		6
@@ -131,30 +135,19 @@ void runCommand(char command)
 
 		case 'L':
 		{
-			uint8_t 	arrayLength		= 25;
-
-			char 		fileNames[arrayLength][12];
-			uint32_t	fileSizes[arrayLength];
+			Serial.println();
+			Serial.println(F("File Listing"));
+			Serial.println(F("========================"));
 
-			uint8_t		numberOfFiles	= _vsUart.listFiles(fileNames, fileSizes, arrayLength);
+			// Each file is printed as it is read, so no arrays are needed to hold the listing.
+			uint8_t		numberOfFiles	= _vsUart.listFiles(printFile);
 
 			if (numberOfFiles > 0)
 			{
-				Serial.println();
-				Serial.println(F("File Listing"));
 				Serial.println(F("========================"));
 				Serial.print(F("Found "));
 				Serial.print(numberOfFiles);
 				Serial.println(F(" files"));
-				for (uint8_t i = 0; i < numberOfFiles; i++)
-				{
-					Serial.print(i);
-					Serial.print(F("\tname: "));
-					Serial.print(fileNames[i]);
-					Serial.print(F("\tsize: "));
-					Serial.println(fileSizes[i]);
-				}
-				Serial.println(F("========================"));
 			}
 			else
 			{
@@ -410,6 +403,18 @@ uint8_t readLine()
 	return index;
 }
 
+bool printFile(uint8_t fileNumber, const char* fileName, uint32_t fileSize)
+{
+	Serial.print(fileNumber);
+	Serial.print(F("\tname: "));
+	Serial.print(fileName);
+	Serial.print(F("\tsize: "));
+	Serial.println(fileSize);
+
+	// Keep going to the end of the listing.
+	return true;
+}
+
 void reportVolumeResult(uint8_t volumeReturned)
 {
 	// This function reports the result of a volume change so it is not duplicated for an up change and a down
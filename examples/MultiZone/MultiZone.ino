@@ -0,0 +1,87 @@
+/*
+	Demonstrates driving several sound boards together with a group.
+
+	Each board is connected to its own hardware serial port of a Mega.  Commands sent to the group go to every board in one pass and
+	the answers are collected in parallel, so the zones are started in the time it takes the slowest board instead of one after the
+	other.  A synchronized play starts every zone within a few milliseconds of the others.
+
+	Usage:
+	Enter a track number from the serial monitor to play it in every zone, or 'q' to stop playing.
+*/
+
+#include "VS1000UART.h"
+#include "VS1000Group.h"
+#include "VS1000HardwareSerialTransport.h"
+
+// Connect to the RST pins on the Sound Boards.
+#define ARDUINO_PIN_FOR_ZONE1_RESET		4
+#define ARDUINO_PIN_FOR_ZONE2_RESET		5
+#define ARDUINO_PIN_FOR_ZONE3_RESET		6
+
+// One transport and one audio class per board.
+VS1000HardwareSerialTransport	_transport1				= VS1000HardwareSerialTransport(&Serial1);
+VS1000HardwareSerialTransport	_transport2				= VS1000HardwareSerialTransport(&Serial2);
+VS1000HardwareSerialTransport	_transport3				= VS1000HardwareSerialTransport(&Serial3);
+VS1000UART 						_zone1 					= VS1000UART(&_transport1, ARDUINO_PIN_FOR_ZONE1_RESET);
+VS1000UART 						_zone2 					= VS1000UART(&_transport2, ARDUINO_PIN_FOR_ZONE2_RESET);
+VS1000UART 						_zone3 					= VS1000UART(&_transport3, ARDUINO_PIN_FOR_ZONE3_RESET);
+
+VS1000Group						_zones;
+
+// Called when a zone has finished the commands it was given.
+void zoneDone(uint8_t board, VS1000UART::COMMANDSTATUS status)
+{
+	Serial.print(F("Zone "));
+	Serial.print(board + 1);
+	if (status == VS1000UART::STATUSSUCCESS)
+	{
+		Serial.println(F(" done."));
+	}
+	else
+	{
+		Serial.println(F(" failed."));
+	}
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	_transport1.begin(9600);
+	_transport2.begin(9600);
+	_transport3.begin(9600);
+	_zone1.begin();
+	_zone2.begin();
+	_zone3.begin();
+
+	// Reset all the boards at once.
+	_zones.add(&_zone1);
+	_zones.add(&_zone2);
+	_zones.add(&_zone3);
+	_zones.queueCommand(VS1000UART::COMMANDRESET);
+	_zones.waitForIdle();
+
+	_zones.setBoardCallback(zoneDone);
+
+	Serial.println(F("Audio ready."));
+}
+
+void loop()
+{
+	// Moves every board along.  Returns right away.
+	_zones.poll();
+
+	if (Serial.available())
+	{
+		char characterRead = Serial.read();
+
+		if (isdigit(characterRead))
+		{
+			_zones.queuePlaySynchronized(characterRead - '0');
+		}
+		else if (characterRead == 'q')
+		{
+			_zones.queueCommand(VS1000UART::COMMANDSTOP);
+		}
+	}
+}
@@ -17,6 +17,10 @@
 #include <SoftwareSerial.h>
 #include "VS1000UART.h"
 
+#if !VS1000PERSISTENCE
+	#error This example needs VS1000PERSISTENCE.
+#endif
+
 // Choose any two pins that can be used with SoftwareSerial to RX & TX.
 #define SFX_TX 5
 #define SFX_RX 6
@@ -33,7 +37,8 @@
 SoftwareSerial	_softwareSerial				= SoftwareSerial(SFX_TX, SFX_RX);
 
 // Pass the software serial to the audio class, the second argument is the reset pin number, and the third number is the memory address
-// used to store the volume.  If you are not using any other memory, it is recommended to use 0.
+// used to store the volume.  If you are not using any other memory, it is recommended to use 0.  Saves rotate through 8 slots of
+// 2 bytes to spread the wear on the memory, so 16 bytes are used (see "setVolumeMemorySlots").
 VS1000UART 		_vsUart 					= VS1000UART(&_softwareSerial, SFX_RST, 0);
 
 // A 'function' to reset the Arduino.  It is a function pointer to the first memory address.  Causing execution to start from there is a restart.
@@ -0,0 +1,95 @@
+/*
+	Demonstrates continuous play mode.
+
+	A playlist of file numbers is played back to back.  Each track is started from "poll" as soon as the last one ends, so "loop"
+	must not block.  Connecting the ACT pin of the Sound Board gives the shortest gap between tracks.
+
+	Usage:
+	Enter 'o' to play the list once, 'l' to loop it, 's' to shuffle it, or 'q' to stop playing.
+*/
+
+#include <SoftwareSerial.h>
+#include "VS1000UART.h"
+
+// Arduino pins that can be used with SoftwareSerial.
+#define ARDUINO_PIN_RX_FROM_AUDIO_TX	5
+#define ARDUINO_PIN_TX_TO_AUDIO_RX		6
+
+// Connect to the RST pin on the Sound Board.
+#define ARDUINO_PIN_FOR_AUDIO_RESET		4
+
+// Connect to the ACT pin on the Sound Board.  Pin 2 has an interrupt on most boards.
+#define ARDUINO_PIN_FOR_AUDIO_ACTIVITY	2
+
+// We'll be using software serial.
+SoftwareSerial	_softwareSerial				= SoftwareSerial(ARDUINO_PIN_RX_FROM_AUDIO_TX, ARDUINO_PIN_TX_TO_AUDIO_RX);
+
+// Pass the software serial to the audio class and the reset pin.
+VS1000UART 		_vsUart 					= VS1000UART(&_softwareSerial, ARDUINO_PIN_FOR_AUDIO_RESET);
+
+// File numbers to play, in order.
+const uint8_t	_playlist[]					= { 0, 2, 1, 3 };
+
+// Called each time the next track of the playlist starts.
+void trackStarted(uint8_t position, uint8_t fileNumber)
+{
+	Serial.print(F("Playing list position "));
+	Serial.print(position);
+	Serial.print(F(", file "));
+	Serial.println(fileNumber);
+}
+
+void setup()
+{
+	// Must call "begin" on serial stream before VS1000UART.
+	Serial.begin(115200);
+	_softwareSerial.begin(9600);
+	_vsUart.setActivityPin(ARDUINO_PIN_FOR_AUDIO_ACTIVITY);
+	_vsUart.begin();
+
+	if (!_vsUart.reset())
+	{
+		Serial.println(F("VS1000 failed to reset."));
+
+		// Something went wrong, so we freeze.
+		while (1)
+		{
+		}
+	}
+
+	_vsUart.setPlaylist(_playlist, sizeof(_playlist));
+	_vsUart.setTrackCallback(trackStarted);
+
+	// Shuffle differently each time.
+	randomSeed(analogRead(A0));
+
+	Serial.println(F("Audio ready."));
+}
+
+void loop()
+{
+	// Starts the next track when the last one ends.
+	_vsUart.poll();
+
+	if (Serial.available())
+	{
+		switch (Serial.read())
+		{
+			case 'o':
+				_vsUart.continuousPlayMode(VS1000UART::PLAYLISTONCE);
+				break;
+
+			case 'l':
+				_vsUart.continuousPlayMode(VS1000UART::PLAYLISTLOOP);
+				break;
+
+			case 's':
+				_vsUart.continuousPlayMode(VS1000UART::PLAYLISTSHUFFLE);
+				break;
+
+			case 'q':
+				_vsUart.queueCommand(VS1000UART::COMMANDSTOP);
+				break;
+		}
+	}
+}
@@ -0,0 +1,97 @@
+/*
+	Demonstrates picking up where the player was after the Arduino has been restarted or powered off.
+
+	The volume, the volume limits, the last track, and the playlist position are saved to the Arduino's memory (EEPROM) as they
+	change.  After a restart, "restoreState" sets the volume and starts the playlist again at the track it was on.  Each save goes
+	to the next of four slots, so a new track doesn't wear the same bytes every time.
+
+	Usage:
+	Let the playlist play for a while, then restart the Arduino.  It goes on with the same track at the same volume.  Enter '+' or
+	'-' from the serial monitor to change the volume.
+*/
+
+#include <SoftwareSerial.h>
+#include "VS1000UART.h"
+
+#if !VS1000PERSISTENCE
+	#error This example needs VS1000PERSISTENCE.
+#endif
+
+// Arduino pins that can be used with SoftwareSerial.
+#define ARDUINO_PIN_RX_FROM_AUDIO_TX	5
+#define ARDUINO_PIN_TX_TO_AUDIO_RX		6
+
+// Connect to the RST pin on the Sound Board.
+#define ARDUINO_PIN_FOR_AUDIO_RESET		4
+
+// Connect to the ACT pin on the Sound Board, so the end of each track is seen.
+#define ARDUINO_PIN_FOR_AUDIO_ACTIVITY	2
+
+// Memory used for saving.  The snapshot uses four slots of 20 bytes, it is put after the 16 bytes of the volume.
+#define MEMORY_ADDRESS_VOLUME			0
+#define MEMORY_ADDRESS_STATE			16
+
+// We'll be using software serial.
+SoftwareSerial	_softwareSerial				= SoftwareSerial(ARDUINO_PIN_RX_FROM_AUDIO_TX, ARDUINO_PIN_TX_TO_AUDIO_RX);
+
+// Pass the software serial to the audio class, the reset pin, and the memory address of the volume.
+VS1000UART 		_vsUart 					= VS1000UART(&_softwareSerial, ARDUINO_PIN_FOR_AUDIO_RESET, MEMORY_ADDRESS_VOLUME);
+
+// Numbers of the files to play.  The snapshot only picks the playlist up again if the same one is set.
+const uint8_t	_playlist[]					= { 0, 1, 2 };
+
+void setup()
+{
+	// Must call "begin" on serial stream before VS1000UART.
+	Serial.begin(115200);
+	_softwareSerial.begin(9600);
+
+	_vsUart.setActivityPin(ARDUINO_PIN_FOR_AUDIO_ACTIVITY);
+	_vsUart.useStateSnapshot(MEMORY_ADDRESS_STATE);
+
+	// Turning the volume quickly only saves where it stops.
+	_vsUart.setVolumeSaveDelay(1000);
+	_vsUart.setPlaylist(_playlist, sizeof(_playlist));
+	_vsUart.begin();
+
+	if (!_vsUart.reset())
+	{
+		Serial.println(F("VS1000 failed to reset."));
+
+		// Something went wrong, so we freeze.
+		while (1)
+		{
+		}
+	}
+
+	// The first time there is nothing saved, so the playlist is started from the top.
+	if (_vsUart.restoreState() && _vsUart.isContinuousPlay())
+	{
+		Serial.println(F("Resumed."));
+	}
+	else
+	{
+		_vsUart.continuousPlayMode(VS1000UART::PLAYLISTLOOP);
+		Serial.println(F("Started."));
+	}
+}
+
+void loop()
+{
+	if (Serial.available())
+	{
+		switch (Serial.read())
+		{
+			case '+':
+				_vsUart.queueVolumeLevelStep(1);
+				break;
+
+			case '-':
+				_vsUart.queueVolumeLevelStep(-1);
+				break;
+		}
+	}
+
+	// Starts the tracks of the playlist and saves the state once it has stayed the same for the save delay.
+	_vsUart.poll();
+}
@@ -0,0 +1,313 @@
+/*! \file Benchmark.cpp  */
+
+// Runs the library against the simulated chip and reports, for each scenario, the simulated time on the link, the host time,
+// the bytes sent each way, the size of the driver object, and what the driver took from the heap.
+//
+// Usage: benchmark [baud] [latency in microseconds]
+
+#include <chrono>
+#include <new>
+#include "SimulatedVS1000.h"
+#include "VS1000UART.h"
+#include "VS1000UARTStatic.h"
+
+// Heap use is followed by replacing the global allocator.  Each block remembers its size in front of it.
+static size_t	_heapInUse		= 0;
+
+void* operator new(size_t size)
+{
+	size_t* block = (size_t*)malloc(size + sizeof(size_t));
+	if (!block)
+	{
+		throw std::bad_alloc();
+	}
+	*block		= size;
+	_heapInUse	+= size;
+	return block + 1;
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (memory)
+	{
+		size_t* block = (size_t*)memory - 1;
+		_heapInUse -= *block;
+		free(block);
+	}
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+static unsigned long	_baud			= 9600;
+static unsigned long	_latency		= 2000;
+static unsigned int		_failures		= 0;
+static unsigned int		_listedFiles	= 0;
+static unsigned int		_trackEnds		= 0;
+
+bool countFile(uint8_t, const char*, uint32_t)
+{
+	_listedFiles++;
+	return true;
+}
+
+void countTrackEnd()
+{
+	_trackEnds++;
+}
+
+static void pollFor(VS1000UART& uart, unsigned long milliseconds)
+{
+	unsigned long start = millis();
+	while (millis() - start < milliseconds)
+	{
+		uart.poll();
+	}
+}
+
+// One scenario: a fresh chip and driver, set up, then the measured part.
+class Scenario
+{
+	public:
+		Scenario(const char* name, uint16_t fileCount) :
+			_name(name),
+			_chip(_baud)
+		{
+			char fileName[12];
+			_chip.setLatency(_latency);
+			for (uint16_t i = 0; i < fileCount; i++)
+			{
+				snprintf(fileName, sizeof(fileName), "%03uTRACKWAV", (unsigned)(i % 1000));
+				_chip.addFile(fileName, 51892 + i, 5);
+			}
+
+			// The driver is made after this, so what it takes from the heap is counted from here.
+			_heapBefore = _heapInUse;
+		}
+
+		SimulatedVS1000& chip()
+		{
+			return _chip;
+		}
+
+		void start()
+		{
+			_driverHeap		= _heapInUse - _heapBefore;
+			_startMicros	= hostMicros;
+			_startTo		= _chip.bytesToChip;
+			_startFrom		= _chip.bytesFromChip;
+			_startHost		= std::chrono::steady_clock::now();
+		}
+
+		void check(bool passed)
+		{
+			if (!passed)
+			{
+				_failures++;
+				printf("  %s: unexpected result\n", _name);
+			}
+		}
+
+		void finish(size_t objectSize)
+		{
+			double hostTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - _startHost).count();
+			printf("%-22s %12.1f %10.1f %8lu %8lu %8u %8u\n", _name, (hostMicros - _startMicros) / 1000.0, hostTime,
+				_chip.bytesToChip - _startTo, _chip.bytesFromChip - _startFrom, (unsigned)objectSize, (unsigned)_driverHeap);
+		}
+
+	private:
+		const char*						_name;
+		SimulatedVS1000					_chip;
+		uint64_t						_startMicros;
+		unsigned long					_startTo;
+		unsigned long					_startFrom;
+		std::chrono::steady_clock::time_point _startHost;
+		size_t							_heapBefore;
+		size_t							_driverHeap;
+};
+
+static void benchmarkReset()
+{
+	Scenario scenario("reset", 10);
+	VS1000UART uart(&scenario.chip(), 4);
+	uart.begin();
+
+	scenario.start();
+	scenario.check(uart.reset());
+	scenario.finish(sizeof(uart));
+}
+
+static void benchmarkVolumeSweep()
+{
+	Scenario scenario("volume sweep 204-0-204", 10);
+	VS1000UART uart(&scenario.chip(), 4);
+	uart.begin();
+	uart.reset();
+
+	scenario.start();
+	scenario.check(uart.setVolume(0) == 0);
+	scenario.check(uart.setVolume(204) == 204);
+	scenario.finish(sizeof(uart));
+}
+
+static void benchmarkVolumeSteps()
+{
+	Scenario scenario("volume 20 single steps", 10);
+	VS1000UART uart(&scenario.chip(), 4);
+	uart.begin();
+	uart.reset();
+
+	scenario.start();
+	for (uint8_t i = 0; i < 10; i++)
+	{
+		uart.volumeDown();
+		uart.volumeUp();
+	}
+	scenario.check(scenario.chip().volume == 204);
+	scenario.finish(sizeof(uart));
+}
+
+static void benchmarkListFiles()
+{
+	Scenario scenario("list 200 files", 200);
+	VS1000UART uart(&scenario.chip(), 4);
+	uart.begin();
+	uart.reset();
+
+	_listedFiles = 0;
+	scenario.start();
+	scenario.check(uart.listFiles(countFile) == 200);
+	scenario.check(_listedFiles == 200);
+	scenario.finish(sizeof(uart));
+}
+
+static void benchmarkPlayStop()
+{
+	Scenario scenario("50 play/stop", 10);
+	VS1000UART uart(&scenario.chip(), 4);
+	uart.begin();
+	uart.reset();
+
+	scenario.start();
+	for (uint8_t i = 0; i < 50; i++)
+	{
+		scenario.check(uart.playFile((uint8_t)(i % 10)));
+		scenario.check(uart.stopPlay());
+	}
+	scenario.finish(sizeof(uart));
+}
+
+static void benchmarkQueuedPlayStop()
+{
+	Scenario scenario("50 queued play/stop", 10);
+	VS1000UART uart(&scenario.chip(), 4);
+	uart.begin();
+	uart.reset();
+
+	scenario.start();
+	for (uint8_t i = 0; i < 50; i++)
+	{
+		scenario.check(uart.queueCommand(VS1000UART::COMMANDPLAYNUMBER, i % 10));
+		scenario.check(uart.queueCommand(VS1000UART::COMMANDSTOP));
+		while (!uart.isIdle())
+		{
+			uart.poll();
+		}
+	}
+	scenario.finish(sizeof(uart));
+}
+
+static void benchmarkStaticPlayStop()
+{
+	Scenario scenario("50 play/stop static", 10);
+	VS1000UARTStatic<> uart(&scenario.chip(), 4);
+	uart.begin();
+	uart.reset();
+
+	scenario.start();
+	for (uint8_t i = 0; i < 50; i++)
+	{
+		scenario.check(uart.playFile((uint8_t)(i % 10)));
+		scenario.check(uart.stopPlay());
+	}
+	scenario.finish(sizeof(uart));
+}
+
+// ACT goes high as soon as the chip pauses, before the answer to the pause is read, which must not count as the end of the track.
+// A track that ends while its play is being answered must.  Pins 0 to 3 have interrupts, others are read by "poll."
+static void benchmarkPauseResume(const char* name, int activityPin)
+{
+	Scenario scenario(name, 10);
+	scenario.chip().addFile("SHORT   WAV", 100, 0);
+	scenario.chip().setPins(4, activityPin);
+	VS1000UART uart(&scenario.chip(), 4);
+	uart.setActivityPin(activityPin);
+	uart.setTrackEndCallback(countTrackEnd);
+	uart.begin();
+	uart.reset();
+
+	_trackEnds = 0;
+	scenario.start();
+	for (uint8_t i = 0; i < 10; i++)
+	{
+		scenario.check(uart.playFile(i));
+		pollFor(uart, 200);
+		scenario.check(uart.pausePlay());
+		pollFor(uart, 200);
+		scenario.check(uart.resumePlay());
+		pollFor(uart, 200);
+		scenario.check(uart.isPlaying());
+		scenario.check(uart.stopPlay());
+	}
+	scenario.check(_trackEnds == 0);
+
+	scenario.check(uart.playFile(10));
+	pollFor(uart, 200);
+	scenario.check(!uart.isPlaying());
+	scenario.check(_trackEnds == 1);
+	scenario.finish(sizeof(uart));
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1)
+	{
+		_baud = strtoul(argv[1], NULL, 10);
+	}
+	if (argc > 2)
+	{
+		_latency = strtoul(argv[2], NULL, 10);
+	}
+
+	printf("%lu baud, %lu us latency.  Object and heap sizes are for this host, not the Arduino.\n", _baud, _latency);
+	printf("%-22s %12s %10s %8s %8s %8s %8s\n", "scenario", "link ms", "host us", "to chip", "from", "object", "heap");
+
+	benchmarkReset();
+	benchmarkVolumeSweep();
+	benchmarkVolumeSteps();
+	benchmarkListFiles();
+	benchmarkPlayStop();
+	benchmarkQueuedPlayStop();
+	benchmarkStaticPlayStop();
+	benchmarkPauseResume("pause/resume ACT polled", 7);
+	benchmarkPauseResume("pause/resume ACT irq", 2);
+
+	return _failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,346 @@
+/*! \file SimulatedVS1000.cpp  */
+
+#include "SimulatedVS1000.h"
+
+SimulatedVS1000* selectedChip = NULL;
+
+SimulatedVS1000::SimulatedVS1000(unsigned long baud) :
+	bytesToChip(0),
+	bytesFromChip(0),
+	volume(204),
+	playing(-1),
+	playStart(0),
+	_baud(baud),
+	_latency(2000),
+	_bootTime(400000),
+	_bootAt(0),
+	_pausedAt(0),
+	_paused(false),
+	_activity(HIGH),
+	_inReset(false),
+	_bugArmed(false),
+	_resetPin(4),
+	_activityPin(-1)
+{
+	select();
+}
+
+void SimulatedVS1000::addFile(const char* name, uint32_t size, uint32_t seconds)
+{
+	File file = { name, size, seconds };
+	_files.push_back(file);
+}
+
+void SimulatedVS1000::setBaud(unsigned long baud)
+{
+	_baud = baud;
+}
+
+void SimulatedVS1000::setLatency(unsigned long microseconds)
+{
+	_latency = microseconds;
+}
+
+void SimulatedVS1000::setBootTime(unsigned long microseconds)
+{
+	_bootTime = microseconds;
+}
+
+void SimulatedVS1000::setPins(int resetPin, int activityPin)
+{
+	_resetPin		= resetPin;
+	_activityPin	= activityPin;
+}
+
+void SimulatedVS1000::select()
+{
+	selectedChip = this;
+}
+
+int SimulatedVS1000::available()
+{
+	update();
+
+	int count = 0;
+	while (count < (int)_receive.size() && _receive[count].time <= hostMicros)
+	{
+		count++;
+	}
+	return count;
+}
+
+int SimulatedVS1000::read()
+{
+	hostMicros++;
+	update();
+
+	if (_receive.empty() || _receive.front().time > hostMicros)
+	{
+		return -1;
+	}
+
+	char character = _receive.front().value;
+	_receive.pop_front();
+	bytesFromChip++;
+	return (uint8_t)character;
+}
+
+int SimulatedVS1000::peek()
+{
+	update();
+
+	if (_receive.empty() || _receive.front().time > hostMicros)
+	{
+		return -1;
+	}
+	return (uint8_t)_receive.front().value;
+}
+
+size_t SimulatedVS1000::write(uint8_t character)
+{
+	// The sender waits while the byte goes out.
+	hostMicros += byteTime();
+	update();
+	bytesToChip++;
+
+	if (_inReset || _bootAt)
+	{
+		return 1;
+	}
+
+	// Single character commands act right away, the rest wait for the end of the line.
+	if (_line.empty() && strchr("+-ts=>q", character))
+	{
+		execute(std::string(1, (char)character));
+		return 1;
+	}
+
+	if (character == '\r')
+	{
+		return 1;
+	}
+
+	if (character == '\n')
+	{
+		// An empty line clears the play time bug.
+		if (_line.empty())
+		{
+			_bugArmed = false;
+			return 1;
+		}
+
+		execute(_line);
+		_line.clear();
+		return 1;
+	}
+
+	_line += (char)character;
+	return 1;
+}
+
+void SimulatedVS1000::update()
+{
+	if (_bootAt && hostMicros >= _bootAt)
+	{
+		_bootAt = 0;
+		boot();
+	}
+
+	if (playing >= 0 && !_paused && hostMicros - playStart >= (uint64_t)_files[playing].seconds * 1000000ULL)
+	{
+		playing = -1;
+	}
+
+	updateActivity();
+}
+
+void SimulatedVS1000::pinChanged(int pin, int mode, int value)
+{
+	if (pin != _resetPin)
+	{
+		return;
+	}
+
+	// Held low, the chip is in reset.  Let go, it boots after the boot time.
+	if (mode == OUTPUT && value == LOW)
+	{
+		_inReset = true;
+		_receive.clear();
+		_line.clear();
+	}
+	else if (_inReset)
+	{
+		_inReset	= false;
+		_bootAt		= hostMicros + _bootTime + 1;
+	}
+}
+
+int SimulatedVS1000::pinValue(int pin)
+{
+	if (pin == _activityPin)
+	{
+		update();
+		return _activity;
+	}
+	return LOW;
+}
+
+void SimulatedVS1000::reply(const std::string& text)
+{
+	uint64_t time = hostMicros + _latency;
+	if (!_receive.empty() && _receive.back().time > time)
+	{
+		time = _receive.back().time;
+	}
+
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		time += byteTime();
+		Byte byte = { time, text[i] };
+		_receive.push_back(byte);
+	}
+}
+
+void SimulatedVS1000::updateActivity()
+{
+	// ACT is low while playing, high when paused or stopped.
+	int activity = playing >= 0 && !_paused ? LOW : HIGH;
+	if (activity != _activity)
+	{
+		_activity = activity;
+		if (_activityPin >= 0)
+		{
+			hostPinChanged(_activityPin);
+		}
+	}
+}
+
+void SimulatedVS1000::execute(const std::string& line)
+{
+	char buffer[64];
+
+	switch (line[0])
+	{
+		case '+':
+		case '-':
+			volume += line[0] == '+' ? 2 : -2;
+			volume = volume > 204 ? 204 : (volume < 0 ? 0 : volume);
+			snprintf(buffer, sizeof(buffer), "%d\r\n", volume);
+			reply(buffer);
+			break;
+
+		case '#':
+		case 'P':
+		{
+			int index = -1;
+			if (line[0] == '#')
+			{
+				index = atoi(line.c_str() + 1);
+			}
+			for (size_t i = 0; line[0] == 'P' && i < _files.size(); i++)
+			{
+				if (_files[i].name == line.substr(1))
+				{
+					index = i;
+				}
+			}
+
+			if (index < 0 || index >= (int)_files.size())
+			{
+				reply("NoFile\r\n");
+				break;
+			}
+
+			playing		= index;
+			playStart	= hostMicros;
+			_paused		= false;
+			snprintf(buffer, sizeof(buffer), "\r\nplay\t%03d\t%s\r\n", index, _files[index].name.c_str());
+			reply(buffer);
+			break;
+		}
+
+		case '=':
+		case '>':
+		case 'q':
+			// A paused track doesn't move on.
+			if (line[0] == '=' && playing >= 0 && !_paused)
+			{
+				_paused		= true;
+				_pausedAt	= hostMicros;
+			}
+			else if (line[0] == '>' && _paused)
+			{
+				_paused		= false;
+				playStart	+= hostMicros - _pausedAt;
+			}
+			else if (line[0] == 'q')
+			{
+				playing		= -1;
+				_paused		= false;
+			}
+			snprintf(buffer, sizeof(buffer), "%c\r\n", line[0]);
+			reply(buffer);
+			break;
+
+		case 't':
+			// Asking while not playing sets off the firmware bug.
+			if (playing < 0)
+			{
+				_bugArmed = true;
+				reply("\r\n");
+				break;
+			}
+			snprintf(buffer, sizeof(buffer), "%05u:%05u\r\n", (unsigned)((hostMicros - playStart) / 1000000ULL), (unsigned)_files[playing].seconds);
+			reply(buffer);
+			break;
+
+		case 's':
+		{
+			if (playing < 0)
+			{
+				reply("\r\n");
+				break;
+			}
+			uint32_t total	= _files[playing].size;
+			uint32_t played	= (uint32_t)((double)(hostMicros - playStart) / (_files[playing].seconds * 1000000.0) * total);
+			snprintf(buffer, sizeof(buffer), "%010lu/%010lu\r\n", (unsigned long)(total - played), (unsigned long)total);
+			reply(buffer);
+			break;
+		}
+
+		case 'L':
+			if (_bugArmed)
+			{
+				break;
+			}
+			for (size_t i = 0; i < _files.size(); i++)
+			{
+				snprintf(buffer, sizeof(buffer), "%-11s\t%010lu\r\n", _files[i].name.c_str(), (unsigned long)_files[i].size);
+				reply(buffer);
+			}
+			break;
+	}
+
+	// Takes effect before the answer is read.
+	updateActivity();
+}
+
+void SimulatedVS1000::boot()
+{
+	char buffer[32];
+
+	volume		= 204;
+	playing		= -1;
+	_paused		= false;
+	_bugArmed	= false;
+
+	reply("\r\nAdafruit FX Sound Board 9/10/14\r\n\r\nFAT type: FAT16\r\n");
+	snprintf(buffer, sizeof(buffer), "Files: %d\r\n", (int)_files.size());
+	reply(buffer);
+}
+
+unsigned long SimulatedVS1000::byteTime()
+{
+	// Start bit, 8 data bits, stop bit.
+	return 10000000UL / _baud;
+}
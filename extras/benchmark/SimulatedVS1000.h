@@ -0,0 +1,100 @@
+/*! @file SimulatedVS1000.h */
+
+#ifndef SIMULATEDVS1000_H
+#define SIMULATEDVS1000_H
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include <deque>
+
+/// \brief Model of the VS1000 firmware on an Adafruit FX Sound Board, seen as a Stream.
+///
+/// Covers the boot banner, the file listing, play by number and name, the volume echo, pause, resume, stop, the play time and size,
+/// and the play time bug that breaks a later listing.  Writing a byte takes one byte time at the baud rate, like SoftwareSerial.
+/// Answers become readable after the latency plus one byte time per byte.  The reset pin and the ACT pin are followed through the
+/// pin functions of the host core.  ACT changes as soon as a command takes effect, before its answer, and raises the pin's
+/// interrupt.
+class SimulatedVS1000 : public Stream
+{
+	public:
+		struct File
+		{
+			std::string				name;
+			uint32_t				size;
+			uint32_t				seconds;
+		};
+
+	// Constructors.
+	public:
+		/// \brief Constructor.  The newest instance is the one the pin functions and the clock talk to.
+		SimulatedVS1000(unsigned long baud = 9600);
+
+	// Setup functions.
+	public:
+		/// \brief Adds a file.  Names are 11 characters, 8.3 without the dot.
+		void addFile(const char* name, uint32_t size, uint32_t seconds);
+		void setBaud(unsigned long baud);
+		void setLatency(unsigned long microseconds);
+		void setBootTime(unsigned long microseconds);
+		void setPins(int resetPin, int activityPin);
+
+		/// \brief Makes the chip the one the pin functions and the clock talk to.
+		void select();
+
+	// Stream.
+	public:
+		int available();
+		int read();
+		int peek();
+		size_t write(uint8_t character);
+		using Print::write;
+		int availableForWrite() { return 64; }
+
+	// Hooks for the host core.
+	public:
+		void update();
+		void pinChanged(int pin, int mode, int value);
+		int pinValue(int pin);
+
+	public:
+		unsigned long				bytesToChip;
+		unsigned long				bytesFromChip;
+		int							volume;
+		int							playing;
+		uint64_t					playStart;
+
+	private:
+		void reply(const std::string& text);
+		void updateActivity();
+		void execute(const std::string& line);
+		void boot();
+		unsigned long byteTime();
+
+	private:
+		struct Byte
+		{
+			uint64_t				time;
+			char					value;
+		};
+
+		std::vector<File>			_files;
+		std::deque<Byte>			_receive;
+		std::string					_line;
+		unsigned long				_baud;
+		unsigned long				_latency;
+		unsigned long				_bootTime;
+		uint64_t					_bootAt;
+		uint64_t					_pausedAt;
+		bool						_paused;
+		int							_activity;
+		bool						_inReset;
+		bool						_bugArmed;
+		int							_resetPin;
+		int							_activityPin;
+};
+
+/// \brief Chip the pin functions and the clock talk to.
+extern SimulatedVS1000* selectedChip;
+
+#endif
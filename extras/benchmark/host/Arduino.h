@@ -0,0 +1,109 @@
+/*! @file Arduino.h */
+
+// Host stand in for the parts of the Arduino core used by the library.  Time is simulated: it only moves when the code asks for it
+// or bytes are sent, so runs are repeatable and measure the link instead of the host computer.
+
+#ifndef BENCHMARK_ARDUINO_H
+#define BENCHMARK_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <stdio.h>
+
+// Flash memory is ordinary memory on the host.
+#define PROGMEM
+#define F(text)						(reinterpret_cast<const __FlashStringHelper*>(text))
+#define PSTR(text)					(text)
+#define pgm_read_byte(address)		(*(const uint8_t*)(address))
+#define pgm_read_word(address)		(*(const uint16_t*)(address))
+#define pgm_read_dword(address)		(*(const uint32_t*)(address))
+#define memcpy_P					memcpy
+
+#define INPUT						0
+#define OUTPUT						1
+#define INPUT_PULLUP				2
+#define LOW							0
+#define HIGH						1
+#define CHANGE						1
+#define FALLING						2
+#define RISING						3
+#define NOT_AN_INTERRUPT			-1
+
+// Pins 0 to 3 have interrupts.
+#define digitalPinToInterrupt(pin)	((pin) < 4 ? (pin) : NOT_AN_INTERRUPT)
+#define noInterrupts()
+#define interrupts()
+
+class __FlashStringHelper;
+
+inline char* utoa(unsigned value, char* buffer, int) { sprintf(buffer, "%u", value); return buffer; }
+inline char* ltoa(long value, char* buffer, int) { sprintf(buffer, "%ld", value); return buffer; }
+
+// Simulated time in microseconds.
+extern uint64_t hostMicros;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long milliseconds);
+void delayMicroseconds(unsigned int microseconds);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(int interrupt, void (*handler)(), int mode);
+void detachInterrupt(int interrupt);
+long random(long maximum);
+long random(long minimum, long maximum);
+
+// Runs the interrupt handler attached to a pin, for the simulated chip when it changes one of its outputs.
+void hostPinChanged(uint8_t pin);
+
+class Print
+{
+	public:
+		virtual ~Print() {}
+		virtual size_t write(uint8_t character) = 0;
+		virtual size_t write(const uint8_t* buffer, size_t size) { size_t count = 0; while (size--) { count += write(*buffer++); } return count; }
+		virtual int availableForWrite() { return 0; }
+		size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+		size_t print(const __FlashStringHelper* text) { return write((const char*)text); }
+		size_t print(const char* text) { return write(text); }
+		size_t print(char character) { return write((uint8_t)character); }
+		size_t print(unsigned long number) { char buffer[12]; snprintf(buffer, sizeof(buffer), "%lu", number); return write(buffer); }
+		size_t print(long number) { char buffer[12]; snprintf(buffer, sizeof(buffer), "%ld", number); return write(buffer); }
+		size_t print(int number) { return print((long)number); }
+		size_t print(unsigned int number) { return print((unsigned long)number); }
+		size_t print(unsigned char number) { return print((unsigned long)number); }
+		size_t println() { return write("\r\n"); }
+		template <typename T> size_t println(T value) { size_t count = print(value); return count + println(); }
+};
+
+class Stream : public Print
+{
+	public:
+		virtual int available() = 0;
+		virtual int read() = 0;
+		virtual int peek() = 0;
+		void setTimeout(unsigned long) {}
+};
+
+// The serial monitor prints to standard out.
+class HardwareSerial : public Stream
+{
+	public:
+		void begin(unsigned long) {}
+		void end() {}
+		void flush() {}
+		int available() { return 0; }
+		int read() { return -1; }
+		int peek() { return -1; }
+		size_t write(uint8_t character) { fputc(character, stdout); return 1; }
+		using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif
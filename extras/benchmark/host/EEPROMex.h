@@ -0,0 +1,35 @@
+/*! @file EEPROMex.h */
+
+// Host stand in for the EEPROMex library.  Counts writes so wear can be measured.
+
+#ifndef BENCHMARK_EEPROMEX_H
+#define BENCHMARK_EEPROMEX_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define BENCHMARK_EEPROMSIZE	1024
+
+class EEPROMClassEx
+{
+	public:
+		EEPROMClassEx() : writes(0) { memset(memory, 0xFF, sizeof(memory)); }
+
+		uint8_t read(int address) { return memory[address]; }
+		uint8_t readByte(int address) { return memory[address]; }
+		void write(int address, uint8_t value) { memory[address] = value; writes++; }
+		bool writeByte(int address, uint8_t value) { write(address, value); return true; }
+		bool update(int address, uint8_t value) { if (memory[address] != value) { write(address, value); } return true; }
+		bool updateByte(int address, uint8_t value) { return update(address, value); }
+		int readInt(int address) { return memory[address] | (memory[address + 1] << 8); }
+		bool writeInt(int address, int value) { write(address, value & 0xFF); write(address + 1, (value >> 8) & 0xFF); return true; }
+		bool updateInt(int address, int value) { update(address, value & 0xFF); update(address + 1, (value >> 8) & 0xFF); return true; }
+		int length() { return BENCHMARK_EEPROMSIZE; }
+
+		uint8_t					memory[BENCHMARK_EEPROMSIZE];
+		unsigned long			writes;
+};
+
+extern EEPROMClassEx EEPROM;
+
+#endif
@@ -0,0 +1,108 @@
+/*! \file HostArduino.cpp  */
+
+#include <Arduino.h>
+#include <EEPROMex.h>
+#include "../SimulatedVS1000.h"
+
+uint64_t		hostMicros		= 0;
+HardwareSerial	Serial;
+EEPROMClassEx	EEPROM;
+
+static int		_pinModes[64];
+static int		_pinValues[64];
+static void		(*_interruptHandlers[4])();
+
+// Every look at the clock moves it on a little, so polling loops always end.
+unsigned long millis()
+{
+	return micros() / 1000;
+}
+
+unsigned long micros()
+{
+	hostMicros++;
+	if (selectedChip)
+	{
+		selectedChip->update();
+	}
+	return (unsigned long)hostMicros;
+}
+
+void delay(unsigned long milliseconds)
+{
+	hostMicros += milliseconds * 1000ULL;
+	if (selectedChip)
+	{
+		selectedChip->update();
+	}
+}
+
+void delayMicroseconds(unsigned int microseconds)
+{
+	hostMicros += microseconds;
+}
+
+void yield()
+{
+	hostMicros++;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	_pinModes[pin] = mode;
+	if (selectedChip)
+	{
+		selectedChip->pinChanged(pin, mode, _pinValues[pin]);
+	}
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	_pinValues[pin] = value;
+	if (selectedChip)
+	{
+		selectedChip->pinChanged(pin, _pinModes[pin], value);
+	}
+}
+
+int digitalRead(uint8_t pin)
+{
+	hostMicros++;
+	return selectedChip ? selectedChip->pinValue(pin) : _pinValues[pin];
+}
+
+// Only changes the simulated chip makes to its pins raise interrupts, see "hostPinChanged."
+void attachInterrupt(int interrupt, void (*handler)(), int)
+{
+	if (interrupt >= 0 && interrupt < 4)
+	{
+		_interruptHandlers[interrupt] = handler;
+	}
+}
+
+void detachInterrupt(int interrupt)
+{
+	if (interrupt >= 0 && interrupt < 4)
+	{
+		_interruptHandlers[interrupt] = NULL;
+	}
+}
+
+void hostPinChanged(uint8_t pin)
+{
+	int interrupt = digitalPinToInterrupt(pin);
+	if (interrupt != NOT_AN_INTERRUPT && _interruptHandlers[interrupt])
+	{
+		_interruptHandlers[interrupt]();
+	}
+}
+
+long random(long maximum)
+{
+	return maximum > 0 ? rand() % maximum : 0;
+}
+
+long random(long minimum, long maximum)
+{
+	return minimum + random(maximum - minimum);
+}
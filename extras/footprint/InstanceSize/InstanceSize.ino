@@ -0,0 +1,21 @@
+/*
+	Not a sketch to upload.  "footprint.sh" builds it to find the size of the driver object and of the transport it makes for a
+	Stream.  Each size is put in a template that has no definition, so the build fails with the size in the error.
+*/
+
+#include "VS1000UART.h"
+#include "VS1000StreamTransport.h"
+
+template <int SIZE> struct ObjectSize;
+template <int SIZE> struct TransportSize;
+
+ObjectSize<sizeof(VS1000UART)>				_objectSize;
+TransportSize<sizeof(VS1000StreamTransport)>	_transportSize;
+
+void setup()
+{
+}
+
+void loop()
+{
+}
@@ -0,0 +1,93 @@
+#!/bin/sh
+# Builds each example with arduino-cli under each build configuration and prints the flash and RAM it uses, then the size of one
+# driver object and what it takes from the heap.
+#
+#	footprint.sh FQBN							Print the report for a board, e.g. arduino:avr:uno.
+#	footprint.sh compare BASELINE REPORT TOLERANCE	Print what grew by more than TOLERANCE bytes, fail if anything did.
+
+cd "$(dirname "$0")" || exit 1
+
+if [ "$1" = "compare" ]
+then
+	# A build that worked in the baseline and doesn't now counts as grown.  Each table's heading names its two columns.
+	awk -v tolerance="$4" '
+		/^#/ || NF == 0 { next }
+		$2 == "configuration" { first = $3; second = $4; next }
+		FNR == NR { size1[$1 " " $2] = $3; size2[$1 " " $2] = $4; next }
+		($1 " " $2) in size1 {
+			key = $1 " " $2
+			if (size1[key] == "-") next
+			if ($3 == "-" || $3 > size1[key] + tolerance || ($4 != "-" && size2[key] != "-" && $4 > size2[key] + tolerance))
+			{
+				printf "%-24s%-16s %s %s -> %s, %s %s -> %s\n", $1, $2, first, size1[key], $3, second, size2[key], $4
+				grown = 1
+			}
+		}
+		END { exit grown }
+	' "$2" "$3"
+	exit $?
+fi
+
+FQBN=${1:-arduino:avr:uno}
+OFF="-DVS1000PERSISTENCE=0 -DVS1000PLAYBYNAME=0 -DVS1000LISTING=0 -DVS1000PROGRESS=0 -DVS1000DEBUG=0"
+
+# Name and build flags of each configuration.  "full" is the library as shipped, the others each leave out one feature, "minimal"
+# leaves out all of them.
+CONFIGURATIONS="
+full:
+no-persistence:-DVS1000PERSISTENCE=0
+no-playbyname:-DVS1000PLAYBYNAME=0
+no-listing:-DVS1000LISTING=0
+no-progress:-DVS1000PROGRESS=0
+no-debug:-DVS1000DEBUG=0
+minimal:$OFF
+statistics:-DVS1000STATISTICS=1
+"
+
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+echo "# $FQBN"
+printf "%-24s%-16s%8s%8s\n" example configuration flash ram
+
+for SKETCH in ../../examples/*/*.ino
+do
+	EXAMPLE=$(basename "$SKETCH" .ino)
+
+	echo "$CONFIGURATIONS" | while IFS=: read -r NAME FLAGS
+	do
+		[ -z "$NAME" ] && continue
+
+		# A fresh build path for each, so nothing is reused from a build with other flags.  An example that needs a feature that
+		# is left out, or another board, doesn't build and is shown as "-".
+		OUTPUT=$(arduino-cli compile --fqbn "$FQBN" --library ../.. --build-path "$WORK/$EXAMPLE-$NAME" \
+			--build-property "compiler.cpp.extra_flags=$FLAGS" --build-property "compiler.c.extra_flags=$FLAGS" \
+			"$(dirname "$SKETCH")" 2>&1)
+
+		FLASH=$(echo "$OUTPUT" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')
+		RAM=$(echo "$OUTPUT" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')
+		printf "%-24s%-16s%8s%8s\n" "$EXAMPLE" "$NAME" "${FLASH:--}" "${RAM:--}"
+	done
+done
+
+# The RAM above only counts globals.  One driver object is counted there when it is a global, made from a Stream it also takes the
+# transport and the line buffer from the heap.  "InstanceSize" doesn't build, its errors give the sizes.
+LINEBUFFER=$(sed -n 's/.*_defaultLineBufferSize[[:space:]]*=[[:space:]]*\([0-9][0-9]*\);.*/\1/p' ../../src/VS1000UART.cpp)
+
+echo
+printf "%-24s%-16s%8s%8s\n" instance configuration object heap
+
+echo "$CONFIGURATIONS" | while IFS=: read -r NAME FLAGS
+do
+	[ -z "$NAME" ] && continue
+
+	OUTPUT=$(arduino-cli compile --fqbn "$FQBN" --library ../.. --build-path "$WORK/InstanceSize-$NAME" \
+		--build-property "compiler.cpp.extra_flags=$FLAGS" --build-property "compiler.c.extra_flags=$FLAGS" \
+		InstanceSize 2>&1)
+
+	OBJECT=$(echo "$OUTPUT" | sed -n 's/.*ObjectSize<\([0-9][0-9]*\)>.*/\1/p' | head -n 1)
+	TRANSPORT=$(echo "$OUTPUT" | sed -n 's/.*TransportSize<\([0-9][0-9]*\)>.*/\1/p' | head -n 1)
+	HEAP=
+	[ -n "$TRANSPORT" ] && [ -n "$LINEBUFFER" ] && HEAP=$((TRANSPORT + LINEBUFFER))
+	printf "%-24s%-16s%8s%8s\n" VS1000UART "$NAME" "${OBJECT:--}" "${HEAP:--}"
+done
@@ -0,0 +1,48 @@
+/*! @file VS1000Config.h */
+
+#ifndef VS1000CONFIG_H
+#define VS1000CONFIG_H
+
+// Build switches.  Each feature set to 0 is left out of the library completely, its functions don't exist and nothing it uses is
+// linked, which is how a sketch for a small board like the ATmega328 is stripped down to what it needs.  They have to be seen by
+// the library's own files, so set them as build flags, e.g. "--build-property compiler.cpp.extra_flags=-DVS1000LISTING=0" with
+// arduino-cli, not with a "#define" in the sketch.  "extras/footprint" reports the flash and RAM used by each combination.
+
+// Set to 1 to build in the command statistics, see "VS1000Statistics."
+#ifndef VS1000STATISTICS
+	#define VS1000STATISTICS	0
+#endif
+
+// Saving to memory: the volume, the file table, and the state snapshot.  When 0, the constructors that take a memory address and
+// "VS1000EEPROMStorage" don't exist, so the EEPROMex library isn't needed.  EEPROMex only builds for AVR, so it is on by default
+// only there.  On other boards set it to 1 with a library that provides the same "EEPROM" interface.
+#ifndef VS1000PERSISTENCE
+	#if defined(__AVR__)
+		#define VS1000PERSISTENCE	1
+	#else
+		#define VS1000PERSISTENCE	0
+	#endif
+#endif
+
+// Playing by name: "playFile" with a name and "queuePlayFile."
+#ifndef VS1000PLAYBYNAME
+	#define VS1000PLAYBYNAME	1
+#endif
+
+// Listing the files and the file table.  Without it, play by name always sends the name.
+#ifndef VS1000LISTING
+	#define VS1000LISTING		1
+#endif
+
+// The progress queries "playTime" and "fileSize," with their cache, and COMMANDFILESIZE.  COMMANDPLAYTIME is kept, continuous play
+// uses it to find the end of a track without the activity pin.
+#ifndef VS1000PROGRESS
+	#define VS1000PROGRESS		1
+#endif
+
+// Debugging output through the function given by "VS1000UARTStatic."
+#ifndef VS1000DEBUG
+	#define VS1000DEBUG			1
+#endif
+
+#endif
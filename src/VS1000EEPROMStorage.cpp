@@ -0,0 +1,21 @@
+/*! \file VS1000EEPROMStorage.cpp  */
+
+#include "VS1000EEPROMStorage.h"
+
+#if VS1000PERSISTENCE
+
+#include <EEPROMex.h>
+
+VS1000EEPROMStorage VS1000EEPROM;
+
+uint8_t VS1000EEPROMStorage::read(int address)
+{
+	return EEPROM.readByte(address);
+}
+
+void VS1000EEPROMStorage::update(int address, uint8_t value)
+{
+	EEPROM.updateByte(address, value);
+}
+
+#endif
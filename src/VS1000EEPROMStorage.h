@@ -0,0 +1,28 @@
+/*! @file VS1000EEPROMStorage.h */
+
+#ifndef VS1000EEPROMSTORAGE_H
+#define VS1000EEPROMSTORAGE_H
+
+#include "VS1000Config.h"
+#include "VS1000Storage.h"
+
+#if VS1000PERSISTENCE
+
+/// \brief Saves settings to the Arduino's EEPROM memory.  Only built in with VS1000PERSISTENCE, so the EEPROMex library isn't
+/// needed without it.
+class VS1000EEPROMStorage : public VS1000Storage
+{
+	public:
+		/// \brief Reads one byte from EEPROM.
+		uint8_t read(int address);
+
+		/// \brief Writes one byte to EEPROM if it is different from what is stored.
+		void update(int address, uint8_t value);
+};
+
+/// \brief The EEPROM storage.  It has no state, so one is shared by everything.
+extern VS1000EEPROMStorage VS1000EEPROM;
+
+#endif
+
+#endif
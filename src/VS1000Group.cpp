@@ -0,0 +1,188 @@
+/*! \file VS1000Group.cpp  */
+
+#include "VS1000Group.h"
+
+VS1000Group::VS1000Group() :
+	_count(0),
+	_synchronizing(false),
+	_boardCallback(NULL)
+{
+}
+
+bool VS1000Group::add(VS1000UART* board)
+{
+	if (_count == VS1000GROUPSIZE)
+	{
+		return false;
+	}
+
+	_boards[_count]	= board;
+	_busy[_count]	= !board->isIdle();
+	_count++;
+
+	return true;
+}
+
+uint8_t VS1000Group::getCount()
+{
+	return _count;
+}
+
+VS1000UART* VS1000Group::getBoard(uint8_t board)
+{
+	return _boards[board];
+}
+
+void VS1000Group::setBoardCallback(BoardCallback callback)
+{
+	_boardCallback = callback;
+}
+
+bool VS1000Group::queueCommand(VS1000UART::COMMAND command, uint8_t argument)
+{
+	// Keep going after a full queue so the other boards still get the command.
+	bool queued = true;
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_boards[i]->queueCommand(command, argument))
+		{
+			_busy[i] = true;
+		}
+		else
+		{
+			queued = false;
+		}
+	}
+
+	return queued;
+}
+
+#if VS1000PLAYBYNAME
+bool VS1000Group::queuePlayFile(const char* fileName)
+{
+	bool queued = true;
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_boards[i]->queuePlayFile(fileName))
+		{
+			_busy[i] = true;
+		}
+		else
+		{
+			queued = false;
+		}
+	}
+
+	return queued;
+}
+#endif
+
+bool VS1000Group::queuePlaySynchronized(uint8_t fileNumber)
+{
+	_synchronizing = true;
+	return queueCommand(VS1000UART::COMMANDPLAYARMED, fileNumber);
+}
+
+bool VS1000Group::playSynchronized(uint8_t fileNumber)
+{
+	waitForIdle();
+
+	if (!queuePlaySynchronized(fileNumber))
+	{
+		waitForIdle();
+		return false;
+	}
+
+	waitForIdle();
+
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_boards[i]->getCommandStatus() != VS1000UART::STATUSSUCCESS)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void VS1000Group::poll()
+{
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		_boards[i]->poll();
+	}
+
+	if (_synchronizing)
+	{
+		triggerWhenArmed();
+	}
+
+	// A board that has gone idle since the last poll has finished what it was given.
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_busy[i] && _boards[i]->isIdle())
+		{
+			_busy[i] = false;
+
+			if (_boardCallback)
+			{
+				_boardCallback(i, _boards[i]->getCommandStatus());
+			}
+		}
+	}
+}
+
+bool VS1000Group::isIdle()
+{
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (!_boards[i]->isIdle())
+		{
+			return false;
+		}
+	}
+
+	return !_synchronizing;
+}
+
+void VS1000Group::waitForIdle()
+{
+	while (!isIdle())
+	{
+		poll();
+	}
+}
+
+VS1000UART::COMMANDSTATUS VS1000Group::getCommandStatus(uint8_t board)
+{
+	return _boards[board]->getCommandStatus();
+}
+
+void VS1000Group::triggerWhenArmed()
+{
+	// Wait for every board to have the play on the wire.  A board that has gone idle couldn't queue or send it, so it isn't waited for.
+	bool armed = false;
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_boards[i]->isPlayArmed())
+		{
+			armed = true;
+		}
+		else if (!_boards[i]->isIdle())
+		{
+			return;
+		}
+	}
+
+	// Send the ends of the lines back to back, nothing else in between.
+	if (armed)
+	{
+		for (uint8_t i = 0; i < _count; i++)
+		{
+			_boards[i]->triggerArmedPlay();
+		}
+	}
+
+	_synchronizing = false;
+}
@@ -0,0 +1,98 @@
+/*! @file VS1000Group.h */
+
+#ifndef VS1000GROUP_H
+#define VS1000GROUP_H
+
+#include <Arduino.h>
+#include "VS1000UART.h"
+
+// Most boards a group can hold.
+#define VS1000GROUPSIZE		8
+
+/// \brief Drives several audio boards together.  A command is queued on every board in one pass, then "poll" moves all of them
+/// along at once, so the time taken is that of the slowest board instead of the sum of them.
+///
+/// A synchronized play sends the play to every board but holds back the end of the line.  Once every board has it, the ends of
+/// the lines are sent back to back so the boards start within a few milliseconds of each other.
+class VS1000Group
+{
+	public:
+		/// \brief Function called when a board finishes the commands it was given.
+		/// \param board Index of the board in the group.
+		/// \param status How the last command completed.
+		typedef void (*BoardCallback)(uint8_t board, VS1000UART::COMMANDSTATUS status);
+
+	// Constructors.
+	public:
+		/// \brief Constructor.
+		VS1000Group();
+
+	// Setup functions.
+	public:
+		/// \brief Adds a board to the group.  The board is not owned by the group.
+		/// \param board The board to add.  It should have been started with "begin" and "reset."
+		/// \return Returns false if the group is full.
+		bool add(VS1000UART* board);
+
+		/// \brief Gets the number of boards in the group.
+		uint8_t getCount();
+
+		/// \brief Gets a board in the group.
+		/// \param board Index of the board.
+		VS1000UART* getBoard(uint8_t board);
+
+		/// \brief Sets a function to be called each time a board finishes the commands it was given.
+		/// \param callback Function to call, or NULL for none.
+		void setBoardCallback(BoardCallback callback);
+
+	// Broadcasting.
+	public:
+		/// \brief Adds a command to the queue of every board.
+		/// \param command The command to send.
+		/// \param argument The file number for COMMANDPLAYNUMBER, the volume for COMMANDSETVOLUME, otherwise unused.
+		/// \return Returns false if the queue of any board was full.
+		bool queueCommand(VS1000UART::COMMAND command, uint8_t argument = 0);
+
+		#if VS1000PLAYBYNAME
+		/// \brief Adds a play by name to the queue of every board.
+		/// \param fileName Track name.
+		/// \return Returns false if the queue of any board was full.
+		bool queuePlayFile(const char* fileName);
+		#endif
+
+		/// \brief Adds a synchronized play to the queue of every board.  The boards start together once all of them are ready.
+		/// \param fileNumber Number of the file to play.
+		/// \return Returns false if the queue of any board was full.
+		bool queuePlaySynchronized(uint8_t fileNumber);
+
+		/// \brief Plays a file on every board, starting them together.  Blocks until every board has answered.
+		/// \param fileNumber Number of the file to play.
+		/// \return Returns true if every board started playing.
+		bool playSynchronized(uint8_t fileNumber);
+
+		/// \brief Moves every board forward.  Never blocks.
+		void poll();
+
+		/// \brief Checks if every board has finished its commands.
+		bool isIdle();
+
+		/// \brief Blocks until every board has finished its commands.
+		void waitForIdle();
+
+		/// \brief Gets the status of the last command of a board.
+		/// \param board Index of the board.
+		VS1000UART::COMMANDSTATUS getCommandStatus(uint8_t board);
+
+	private:
+		/// \brief Starts a synchronized play once every board is ready.
+		void triggerWhenArmed();
+
+	private:
+		VS1000UART*					_boards[VS1000GROUPSIZE];
+		bool						_busy[VS1000GROUPSIZE];
+		uint8_t						_count;
+		bool						_synchronizing;
+		BoardCallback				_boardCallback;
+};
+
+#endif
@@ -0,0 +1,54 @@
+/*! \file VS1000HardwareSerialTransport.cpp  */
+
+#include "VS1000HardwareSerialTransport.h"
+
+VS1000HardwareSerialTransport::VS1000HardwareSerialTransport(HardwareSerial* serial) :
+	_serial(serial),
+	_baudRate(0)
+{
+}
+
+void VS1000HardwareSerialTransport::begin(unsigned long baudRate)
+{
+	// The ESP32 receive buffer can only be resized before the port is started.
+	#if defined(ARDUINO_ARCH_ESP32)
+		_serial->setRxBufferSize(256);
+	#endif
+
+	_serial->begin(baudRate);
+	_baudRate = baudRate;
+}
+
+bool VS1000HardwareSerialTransport::setBaudRate(unsigned long baudRate)
+{
+	_serial->flush();
+	_serial->end();
+	begin(baudRate);
+	return true;
+}
+
+unsigned long VS1000HardwareSerialTransport::getBaudRate()
+{
+	return _baudRate;
+}
+
+int VS1000HardwareSerialTransport::receiveByte()
+{
+	return _serial->read();
+}
+
+uint8_t VS1000HardwareSerialTransport::transmitRoom()
+{
+	int room = _serial->availableForWrite();
+	if (room <= 0)
+	{
+		return 0;
+	}
+
+	return room < VS1000TRANSMITBUFFERSIZE ? room : VS1000TRANSMITBUFFERSIZE;
+}
+
+void VS1000HardwareSerialTransport::transmitByte(uint8_t byte)
+{
+	_serial->write(byte);
+}
@@ -0,0 +1,42 @@
+/*! @file VS1000HardwareSerialTransport.h */
+
+#ifndef VS1000HARDWARESERIALTRANSPORT_H
+#define VS1000HARDWARESERIALTRANSPORT_H
+
+#include "VS1000Transport.h"
+
+/// \brief Connection through a hardware UART, e.g. Serial1 on a Mega or Leonardo.  The UART sends from its own interrupt driven buffer
+/// (FIFO or DMA backed on ESP32, RP2040 and SAMD), so bytes are only handed over when there is room and writing never blocks.
+class VS1000HardwareSerialTransport : public VS1000Transport
+{
+	// Constructors.
+	public:
+		/// \brief Constructor.
+		/// \param serial Hardware serial port connected to the chip.
+		VS1000HardwareSerialTransport(HardwareSerial* serial);
+
+	public:
+		/// \brief Starts the serial port.  Use this instead of calling "begin" on the port, it enlarges the receive buffer where the board
+		/// allows it so a full file listing can't overflow it.
+		/// \param baudRate Baud rate.
+		void begin(unsigned long baudRate);
+
+		/// \brief Restarts the serial port at another rate.
+		/// \param baudRate Baud rate.
+		/// \return Returns true.
+		bool setBaudRate(unsigned long baudRate);
+
+		/// \brief Gets the rate the serial port was started at.
+		unsigned long getBaudRate();
+
+	protected:
+		int receiveByte();
+		uint8_t transmitRoom();
+		void transmitByte(uint8_t byte);
+
+	private:
+		HardwareSerial*				_serial;
+		unsigned long				_baudRate;
+};
+
+#endif
@@ -0,0 +1,262 @@
+/*! \file VS1000Input.cpp  */
+
+#include "VS1000Input.h"
+
+// Initialize static members.
+const uint8_t		VS1000Input::_noPin				= 255;
+const uint8_t		VS1000Input::_buttonDown		= 0x01;
+const uint8_t		VS1000Input::_buttonPressed		= 0x02;
+
+// Steps of a quadrature encoder, indexed by the last and the new state of the two pins.  Changes that skip a state count as nothing.
+static const int8_t _encoderSteps[16] PROGMEM = { 0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0 };
+
+VS1000Input::VS1000Input(VS1000UART* audio) :
+	_audio(audio),
+	_count(0),
+	_debounceTime(20),
+	_repeatDelay(500),
+	_repeatInterval(100),
+	_timerTick(false)
+{
+}
+
+bool VS1000Input::addButton(uint8_t pin, ACTION action, uint8_t argument, bool repeat)
+{
+	return add(pin, _noPin, action, ACTIONNONE, argument, repeat);
+}
+
+bool VS1000Input::addEncoder(uint8_t pinA, uint8_t pinB, ACTION clockwise, ACTION counterClockwise, uint8_t stepsPerDetent)
+{
+	// An encoder has no file number, so the argument holds the steps per detent.
+	return add(pinA, pinB, clockwise, counterClockwise, stepsPerDetent > 0 ? stepsPerDetent : 1, false);
+}
+
+void VS1000Input::setDebounceTime(uint8_t debounceTime)
+{
+	_debounceTime = debounceTime;
+}
+
+void VS1000Input::setRepeat(unsigned int delay, unsigned int interval)
+{
+	_repeatDelay	= delay;
+	_repeatInterval	= interval;
+}
+
+void VS1000Input::useTimerTick(bool timerTick)
+{
+	_timerTick = timerTick;
+}
+
+void VS1000Input::tick()
+{
+	unsigned long now = millis();
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_bindings[i].otherPin == _noPin)
+		{
+			tickButton(_bindings[i], now);
+		}
+		else
+		{
+			tickEncoder(_bindings[i]);
+		}
+	}
+}
+
+void VS1000Input::poll()
+{
+	if (!_timerTick)
+	{
+		tick();
+	}
+
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		Binding& binding = _bindings[i];
+
+		noInterrupts();
+		int8_t pending	= binding.pending;
+		binding.pending	= 0;
+		interrupts();
+
+		if (pending == 0)
+		{
+			continue;
+		}
+
+		// Encoders count down for the other direction.
+		bool	other		= pending < 0;
+		uint8_t	count		= other ? -pending : pending;
+		uint8_t	argument	= binding.otherPin == _noPin ? binding.argument : 0;
+		uint8_t	performed	= perform(other ? binding.otherAction : binding.action, argument, count);
+
+		// What didn't fit in the queue is tried again on the next poll.
+		if (performed < count)
+		{
+			noInterrupts();
+			binding.pending += other ? performed - count : count - performed;
+			interrupts();
+		}
+	}
+}
+
+bool VS1000Input::add(uint8_t pin, uint8_t otherPin, ACTION action, ACTION otherAction, uint8_t argument, bool repeat)
+{
+	if (_count == VS1000INPUTSIZE)
+	{
+		return false;
+	}
+
+	Binding& binding	= _bindings[_count];
+	binding.pin			= pin;
+	binding.otherPin	= otherPin;
+	binding.action		= action;
+	binding.otherAction	= otherAction;
+	binding.argument	= argument;
+	binding.repeat		= repeat;
+	binding.state		= 0;
+	binding.stepCount	= 0;
+	binding.changeTime	= millis();
+	binding.pending		= 0;
+
+	pinMode(pin, INPUT_PULLUP);
+	if (otherPin != _noPin)
+	{
+		pinMode(otherPin, INPUT_PULLUP);
+		binding.state = (digitalRead(pin) << 1) | digitalRead(otherPin);
+	}
+
+	// Only counted once it is set up, "tick" may be running from a timer.
+	_count++;
+
+	return true;
+}
+
+void VS1000Input::tickButton(Binding& binding, unsigned long now)
+{
+	// Any change of the pin starts the debounce time over.
+	bool down = digitalRead(binding.pin) == LOW;
+	if (down != ((binding.state & _buttonDown) != 0))
+	{
+		binding.state		^= _buttonDown;
+		binding.changeTime	= now;
+		return;
+	}
+
+	bool pressed = (binding.state & _buttonPressed) != 0;
+	if (down != pressed)
+	{
+		if (now - binding.changeTime >= _debounceTime)
+		{
+			binding.state ^= _buttonPressed;
+			if (down)
+			{
+				binding.changeTime = now;
+				if (binding.pending < 100)
+				{
+					binding.pending++;
+				}
+			}
+		}
+	}
+	else if (pressed && binding.repeat && now - binding.changeTime >= _repeatDelay)
+	{
+		// Moving the time forward by the interval makes each following repeat come one interval later.
+		binding.changeTime += _repeatInterval;
+		if (binding.pending < 100)
+		{
+			binding.pending++;
+		}
+	}
+}
+
+void VS1000Input::tickEncoder(Binding& binding)
+{
+	uint8_t state	= (digitalRead(binding.pin) << 1) | digitalRead(binding.otherPin);
+	int8_t	step	= pgm_read_byte(&_encoderSteps[(binding.state << 2) | state]);
+	binding.state	= state;
+
+	if (step == 0)
+	{
+		return;
+	}
+
+	binding.stepCount += step;
+	if (binding.stepCount >= (int8_t)binding.argument)
+	{
+		binding.stepCount = 0;
+		if (binding.pending < 100)
+		{
+			binding.pending++;
+		}
+	}
+	else if (binding.stepCount <= -(int8_t)binding.argument)
+	{
+		binding.stepCount = 0;
+		if (binding.pending > -100)
+		{
+			binding.pending--;
+		}
+	}
+}
+
+uint8_t VS1000Input::perform(ACTION action, uint8_t argument, uint8_t count)
+{
+	switch (action)
+	{
+		case ACTIONVOLUMELEVELUP:
+			return _audio->queueVolumeLevelStep(count) ? count : 0;
+
+		case ACTIONVOLUMELEVELDOWN:
+			return _audio->queueVolumeLevelStep(-(int8_t)count) ? count : 0;
+
+		case ACTIONPLAYFILE:
+			// Only the last press matters, a newer play replaces a queued one anyway.
+			return _audio->queueCommand(VS1000UART::COMMANDPLAYNUMBER, argument) ? count : 0;
+
+		case ACTIONSTOP:
+			return _audio->queueCommand(VS1000UART::COMMANDSTOP) ? count : 0;
+
+		case ACTIONPAUSE:
+			return _audio->queueCommand(VS1000UART::COMMANDPAUSE) ? count : 0;
+
+		case ACTIONRESUME:
+			return _audio->queueCommand(VS1000UART::COMMANDRESUME) ? count : 0;
+
+		default:
+			break;
+	}
+
+	// The rest are queued one at a time, each is merged into the volume change queued by the last.
+	uint8_t performed = 0;
+	for (; performed < count; performed++)
+	{
+		bool queued = false;
+		switch (action)
+		{
+			case ACTIONCYCLEVOLUMELEVEL:
+				queued = _audio->queueCycleVolumeLevel();
+				break;
+
+			case ACTIONVOLUMEUP:
+				queued = _audio->queueCommand(VS1000UART::COMMANDVOLUMEUP);
+				break;
+
+			case ACTIONVOLUMEDOWN:
+				queued = _audio->queueCommand(VS1000UART::COMMANDVOLUMEDOWN);
+				break;
+
+			default:
+				// Nothing to do.
+				queued = true;
+				break;
+		}
+
+		if (!queued)
+		{
+			break;
+		}
+	}
+
+	return performed;
+}
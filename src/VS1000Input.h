@@ -0,0 +1,127 @@
+/*! @file VS1000Input.h */
+
+#ifndef VS1000INPUT_H
+#define VS1000INPUT_H
+
+#include <Arduino.h>
+#include "VS1000UART.h"
+
+// Most buttons and encoders an input can hold.
+#define VS1000INPUTSIZE		6
+
+/// \brief Binds buttons and rotary encoders to actions on an audio board.  The pins are read and debounced by "tick," which only
+/// counts what happened, and "poll" turns the counts into queued commands.  Presses that come quicker than the chip answers are
+/// merged by the command queue, so holding a volume button or spinning an encoder sends one volume change instead of one for each step.
+///
+/// Buttons are wired between the pin and ground and use the internal pull up.  "tick" can be called from a timer interrupt, which an
+/// encoder turned quickly needs, otherwise "poll" calls it.
+class VS1000Input
+{
+	public:
+		/// \brief What a button press or encoder step does.
+		enum ACTION : uint8_t
+		{
+			ACTIONNONE,
+			ACTIONVOLUMELEVELUP,
+			ACTIONVOLUMELEVELDOWN,
+			ACTIONCYCLEVOLUMELEVEL,
+			ACTIONVOLUMEUP,
+			ACTIONVOLUMEDOWN,
+			ACTIONPLAYFILE,
+			ACTIONSTOP,
+			ACTIONPAUSE,
+			ACTIONRESUME
+		};
+
+	private:
+		struct Binding
+		{
+			uint8_t					pin;
+			uint8_t					otherPin;
+			ACTION					action;
+			ACTION					otherAction;
+			uint8_t					argument;
+			bool					repeat;
+			uint8_t					state;
+			int8_t					stepCount;
+			unsigned long			changeTime;
+			volatile int8_t			pending;
+		};
+
+	// Constructors.
+	public:
+		/// \brief Constructor.
+		/// \param audio The board the actions are queued on.  Not owned by the input.
+		VS1000Input(VS1000UART* audio);
+
+	// Setup functions.
+	public:
+		/// \brief Adds a button.
+		/// \param pin Pin the button is connected to.
+		/// \param action What a press does.
+		/// \param argument The file number for ACTIONPLAYFILE, otherwise unused.
+		/// \param repeat True to repeat the action while the button is held, see "setRepeat."
+		/// \return Returns false if the input is full.
+		bool addButton(uint8_t pin, ACTION action, uint8_t argument = 0, bool repeat = false);
+
+		/// \brief Adds a rotary encoder.  Has no debounce, the order of the pin changes is checked instead.
+		/// \param pinA Pin connected to the A output.
+		/// \param pinB Pin connected to the B output.
+		/// \param clockwise What a step clockwise does.
+		/// \param counterClockwise What a step counter clockwise does.
+		/// \param stepsPerDetent Number of pin changes between the clicks of the encoder, usually 4.
+		/// \return Returns false if the input is full.
+		bool addEncoder(uint8_t pinA, uint8_t pinB, ACTION clockwise = ACTIONVOLUMELEVELUP, ACTION counterClockwise = ACTIONVOLUMELEVELDOWN, uint8_t stepsPerDetent = 4);
+
+		/// \brief Sets how long a button has to stay still before a change is taken.  Defaults to 20 ms.
+		/// \param debounceTime Time in milliseconds.
+		void setDebounceTime(uint8_t debounceTime);
+
+		/// \brief Sets how a held button repeats.  Defaults to the first repeat after 500 ms, then every 100 ms.
+		/// \param delay Time in milliseconds from the press to the first repeat.
+		/// \param interval Time in milliseconds between repeats.
+		void setRepeat(unsigned int delay, unsigned int interval);
+
+		/// \brief Set when "tick" is called from a timer interrupt, so "poll" doesn't call it as well.
+		/// \param timerTick True if a timer calls "tick."
+		void useTimerTick(bool timerTick);
+
+	// Running.
+	public:
+		/// \brief Reads the pins and counts presses and steps.  Safe to call from an interrupt, nothing is sent from here.
+		void tick();
+
+		/// \brief Queues the actions counted since the last call.  Never blocks.  Call from "loop" along with "poll" of the audio class.
+		void poll();
+
+	private:
+		/// \brief Adds a binding.
+		/// \return Returns false if the input is full.
+		bool add(uint8_t pin, uint8_t otherPin, ACTION action, ACTION otherAction, uint8_t argument, bool repeat);
+
+		/// \brief Reads a button.
+		void tickButton(Binding& binding, unsigned long now);
+
+		/// \brief Reads an encoder.
+		void tickEncoder(Binding& binding);
+
+		/// \brief Queues an action a number of times.
+		/// \return Returns how many of them were queued.
+		uint8_t perform(ACTION action, uint8_t argument, uint8_t count);
+
+	private:
+		// Values for "otherPin" and bits of "state" for a button.
+		static const uint8_t		_noPin;
+		static const uint8_t		_buttonDown;
+		static const uint8_t		_buttonPressed;
+
+		VS1000UART*					_audio;
+		Binding						_bindings[VS1000INPUTSIZE];
+		uint8_t						_count;
+		uint8_t						_debounceTime;
+		unsigned int				_repeatDelay;
+		unsigned int				_repeatInterval;
+		bool						_timerTick;
+};
+
+#endif
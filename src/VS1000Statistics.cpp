@@ -0,0 +1,129 @@
+/*! \file VS1000Statistics.cpp  */
+
+#include "VS1000Statistics.h"
+
+#if VS1000STATISTICS
+
+// Names printed for the commands, in the order of VS1000UART::COMMAND.  Each starts with the character sent to the chip.
+static const char _commandNames[VS1000STATISTICSCOMMANDS][15] PROGMEM =
+{
+	"none",
+	"# play",
+	"P play",
+	"+ volume",
+	"- volume",
+	"= pause",
+	"> resume",
+	"q stop",
+	"t play time",
+	"+/- set volume",
+	"reset",
+	"L list files",
+	"s file size",
+	"# armed play"
+};
+
+VS1000Statistics::VS1000Statistics()
+{
+	clear();
+}
+
+void VS1000Statistics::recordCommand(VS1000UART::COMMAND command, VS1000UART::COMMANDSTATUS status, uint32_t time)
+{
+	if (command >= VS1000STATISTICSCOMMANDS)
+	{
+		return;
+	}
+
+	CommandStatistics& statistics = _commands[command];
+
+	if (statistics.count < 65535)
+	{
+		statistics.count++;
+	}
+
+	if (status == VS1000UART::STATUSTIMEDOUT && statistics.timeouts < 65535)
+	{
+		statistics.timeouts++;
+	}
+
+	if (status == VS1000UART::STATUSFAILED && statistics.failures < 65535)
+	{
+		statistics.failures++;
+	}
+
+	if (time < statistics.minimumTime)
+	{
+		statistics.minimumTime = time;
+	}
+
+	if (time > statistics.maximumTime)
+	{
+		statistics.maximumTime = time;
+	}
+
+	// Stops adding at the largest total instead of wrapping, which would make the average wrong.
+	statistics.totalTime = time > 0xFFFFFFFFUL - statistics.totalTime ? 0xFFFFFFFFUL : statistics.totalTime + time;
+}
+
+void VS1000Statistics::recordDrained(VS1000UART::COMMAND command, uint8_t bytes)
+{
+	if (command >= VS1000STATISTICSCOMMANDS)
+	{
+		return;
+	}
+
+	CommandStatistics& statistics = _commands[command];
+	statistics.drainedBytes = bytes > 65535U - statistics.drainedBytes ? 65535U : statistics.drainedBytes + bytes;
+}
+
+const VS1000Statistics::CommandStatistics& VS1000Statistics::getCommandStatistics(VS1000UART::COMMAND command)
+{
+	return _commands[command < VS1000STATISTICSCOMMANDS ? command : VS1000UART::COMMANDNONE];
+}
+
+uint32_t VS1000Statistics::getAverageTime(VS1000UART::COMMAND command)
+{
+	const CommandStatistics& statistics = getCommandStatistics(command);
+	return statistics.count == 0 ? 0 : statistics.totalTime / statistics.count;
+}
+
+void VS1000Statistics::print(Print& output)
+{
+	for (uint8_t command = 0; command < VS1000STATISTICSCOMMANDS; command++)
+	{
+		const CommandStatistics& statistics = _commands[command];
+		if (statistics.count == 0)
+		{
+			continue;
+		}
+
+		output.print((const __FlashStringHelper*)_commandNames[command]);
+		output.print(F(": count "));
+		output.print(statistics.count);
+		output.print(F(", us min "));
+		output.print(statistics.minimumTime);
+		output.print(F(" avg "));
+		output.print(getAverageTime((VS1000UART::COMMAND)command));
+		output.print(F(" max "));
+		output.print(statistics.maximumTime);
+		output.print(F(", timeouts "));
+		output.print(statistics.timeouts);
+		output.print(F(", failures "));
+		output.print(statistics.failures);
+		output.print(F(", drained "));
+		output.println(statistics.drainedBytes);
+	}
+}
+
+void VS1000Statistics::clear()
+{
+	memset(_commands, 0, sizeof(_commands));
+
+	for (uint8_t command = 0; command < VS1000STATISTICSCOMMANDS; command++)
+	{
+		_commands[command].minimumTime = 0xFFFFFFFFUL;
+	}
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*! @file VS1000Statistics.h */
+
+#ifndef VS1000STATISTICS_H
+#define VS1000STATISTICS_H
+
+#include <Arduino.h>
+#include "VS1000UART.h"
+
+// Number of commands statistics are kept for, one for each VS1000UART::COMMAND.
+#define VS1000STATISTICSCOMMANDS	(VS1000UART::COMMANDPLAYARMED + 1)
+
+/// \brief Counts and timings of the commands sent to the audio chip.  For each command it keeps how many were sent, the shortest,
+/// average, and longest time from sending to the answer, how many timed out or got an answer that couldn't be used, and how many
+/// bytes came in that didn't answer any command since the command before it.
+///
+/// Only built in when VS1000STATISTICS is 1, see "VS1000Config.h."  Give it to the audio class with "setStatistics," then read it or
+/// print it whenever wanted.  Recording doesn't print anything, so it doesn't change the timing it measures.
+class VS1000Statistics
+{
+	public:
+		/// \brief Statistics for one command.  Times are in microseconds, the minimum is 0xFFFFFFFF until the command is sent.
+		struct CommandStatistics
+		{
+			uint16_t				count;
+			uint16_t				timeouts;
+			uint16_t				failures;
+			uint16_t				drainedBytes;
+			uint32_t				minimumTime;
+			uint32_t				maximumTime;
+			uint32_t				totalTime;
+		};
+
+	// Constructors.
+	public:
+		/// \brief Constructor.
+		VS1000Statistics();
+
+	// Recording.  Called by the audio class.
+	public:
+		/// \brief Records a completed command.
+		/// \param command The command that completed.
+		/// \param status How the command completed.
+		/// \param time Microseconds from sending to completion.
+		void recordCommand(VS1000UART::COMMAND command, VS1000UART::COMMANDSTATUS status, uint32_t time);
+
+		/// \brief Records bytes that didn't answer anything, received since the last command.
+		/// \param command The command being sent.
+		/// \param bytes Number of bytes.
+		void recordDrained(VS1000UART::COMMAND command, uint8_t bytes);
+
+	// Reading.
+	public:
+		/// \brief Gets the statistics of one command.
+		/// \param command The command.
+		const CommandStatistics& getCommandStatistics(VS1000UART::COMMAND command);
+
+		/// \brief Gets the average time of a command in microseconds, or 0 if it hasn't been sent.
+		/// \param command The command.
+		uint32_t getAverageTime(VS1000UART::COMMAND command);
+
+		/// \brief Prints a line for each command that has been sent.
+		/// \param output Where to print, for example "Serial."
+		void print(Print& output);
+
+		/// \brief Starts counting again from zero.
+		void clear();
+
+	private:
+		CommandStatistics			_commands[VS1000STATISTICSCOMMANDS];
+};
+
+#endif
@@ -0,0 +1,21 @@
+/*! \file VS1000Storage.cpp  */
+
+#include "VS1000Storage.h"
+
+void VS1000Storage::readBlock(int address, void* data, uint8_t length)
+{
+	uint8_t* bytes = (uint8_t*)data;
+	for (uint8_t i = 0; i < length; i++)
+	{
+		bytes[i] = read(address + i);
+	}
+}
+
+void VS1000Storage::updateBlock(int address, const void* data, uint8_t length)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (uint8_t i = 0; i < length; i++)
+	{
+		update(address + i, bytes[i]);
+	}
+}
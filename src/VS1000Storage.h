@@ -0,0 +1,34 @@
+/*! @file VS1000Storage.h */
+
+#ifndef VS1000STORAGE_H
+#define VS1000STORAGE_H
+
+#include <Arduino.h>
+
+/// \brief Interface to the memory used to save settings.  Keeps the memory library out of the build when nothing is saved.
+class VS1000Storage
+{
+	public:
+		/// \brief Reads one byte.
+		/// \param address Memory address.
+		virtual uint8_t read(int address) = 0;
+
+		/// \brief Writes one byte if it is different from what is stored.
+		/// \param address Memory address.
+		/// \param value Value to write.
+		virtual void update(int address, uint8_t value) = 0;
+
+		/// \brief Reads several bytes.
+		/// \param address Memory address of the first byte.
+		/// \param data Buffer for the bytes.
+		/// \param length Number of bytes.
+		void readBlock(int address, void* data, uint8_t length);
+
+		/// \brief Writes several bytes, only the ones that are different are written.
+		/// \param address Memory address of the first byte.
+		/// \param data The bytes to write.
+		/// \param length Number of bytes.
+		void updateBlock(int address, const void* data, uint8_t length);
+};
+
+#endif
@@ -0,0 +1,31 @@
+/*! \file VS1000StreamTransport.cpp  */
+
+#include "VS1000StreamTransport.h"
+
+VS1000StreamTransport::VS1000StreamTransport(Stream* stream) :
+	_stream(stream)
+{
+}
+
+int VS1000StreamTransport::receiveByte()
+{
+	// "read" returns -1 when there is nothing, so there is no need to ask "available" first.
+	return _stream->read();
+}
+
+uint8_t VS1000StreamTransport::transmitRoom()
+{
+	// Streams that don't track their transmit buffer report 0.  Those block until sent, so they can take anything.
+	int room = _stream->availableForWrite();
+	if (room <= 0)
+	{
+		return VS1000TRANSMITBUFFERSIZE;
+	}
+
+	return room < VS1000TRANSMITBUFFERSIZE ? room : VS1000TRANSMITBUFFERSIZE;
+}
+
+void VS1000StreamTransport::transmitByte(uint8_t byte)
+{
+	_stream->write(byte);
+}
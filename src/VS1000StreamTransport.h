@@ -0,0 +1,27 @@
+/*! @file VS1000StreamTransport.h */
+
+#ifndef VS1000STREAMTRANSPORT_H
+#define VS1000STREAMTRANSPORT_H
+
+#include "VS1000Transport.h"
+
+/// \brief Connection through any Stream, e.g. SoftwareSerial.  A Stream can't say how much it can send without blocking, so writes
+/// block for as long as the Stream takes to send (SoftwareSerial sends each byte with interrupts off).
+class VS1000StreamTransport : public VS1000Transport
+{
+	// Constructors.
+	public:
+		/// \brief Constructor.
+		/// \param stream Stream connected to the chip.
+		VS1000StreamTransport(Stream* stream);
+
+	protected:
+		int receiveByte();
+		uint8_t transmitRoom();
+		void transmitByte(uint8_t byte);
+
+	private:
+		Stream*						_stream;
+};
+
+#endif
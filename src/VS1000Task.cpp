@@ -0,0 +1,335 @@
+/*! \file VS1000Task.cpp  */
+
+#include "VS1000Task.h"
+
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_RP2040)
+
+#if defined(ARDUINO_ARCH_RP2040)
+	#include <hardware/sync.h>
+	#include <pico/time.h>
+#endif
+
+VS1000Task::VS1000Task(VS1000UART* audio) :
+	_audio(audio),
+	_posted(0),
+	_taken(0),
+	_finished(0),
+	_volume(audio->getVolume()),
+	_volumeLevel(audio->getVolumeLevel()),
+	_playing(false)
+{
+	for (uint8_t i = 0; i < VS1000TASKQUEUESIZE; i++)
+	{
+		_requests[i].sequence	= 0;
+		_requests[i].posted		= false;
+		_requests[i].status		= VS1000UART::STATUSIDLE;
+		#if defined(ARDUINO_ARCH_ESP32)
+		_requests[i].waiter		= NULL;
+		#endif
+	}
+
+	#if defined(ARDUINO_ARCH_ESP32)
+		portMUX_INITIALIZE(&_lock);
+		_task = NULL;
+	#else
+		critical_section_init(&_lock);
+	#endif
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool VS1000Task::start(BaseType_t core, UBaseType_t priority)
+{
+	if (_task != NULL)
+	{
+		return false;
+	}
+
+	return xTaskCreatePinnedToCore(run, "VS1000", 3072, this, priority, &_task, core) == pdPASS;
+}
+
+void VS1000Task::run(void* task)
+{
+	// Sleeping a tick between passes leaves the core to other tasks.  Bytes wait in the UART buffer meanwhile.
+	for (;;)
+	{
+		((VS1000Task*)task)->service();
+		vTaskDelay(1);
+	}
+}
+#endif
+
+void VS1000Task::service()
+{
+	takeRequests();
+	_audio->poll();
+
+	// The board going idle finishes everything it was given so far.
+	if (_finished != _taken && _audio->isIdle())
+	{
+		finishRequests(_audio->getCommandStatus());
+	}
+
+	_volume			= _audio->getVolume();
+	_volumeLevel	= _audio->getVolumeLevel();
+	_playing		= _audio->isPlaying();
+}
+
+uint16_t VS1000Task::post(VS1000UART::COMMAND command, uint8_t argument)
+{
+	return postRequest(command, argument, false, NULL);
+}
+
+#if VS1000PLAYBYNAME
+uint16_t VS1000Task::postPlayFile(const char* fileName)
+{
+	return postRequest(VS1000UART::COMMANDPLAYNAME, 0, false, fileName);
+}
+#endif
+
+uint16_t VS1000Task::postVolumeLevel(VS1000UART::VOLUMELEVEL level)
+{
+	return postRequest(VS1000UART::COMMANDSETVOLUME, level, true, NULL);
+}
+
+VS1000UART::COMMANDSTATUS VS1000Task::getStatus(uint16_t ticket)
+{
+	// Counted as pending while it is after the last one finished.  The difference is signed so it works across the wrap.
+	if (ticket == 0 || (int16_t)(ticket - _finished) > 0)
+	{
+		return ticket == 0 ? VS1000UART::STATUSIDLE : VS1000UART::STATUSPENDING;
+	}
+
+	__sync_synchronize();
+	const Request& request = _requests[ticket % VS1000TASKQUEUESIZE];
+	VS1000UART::COMMANDSTATUS status = request.status;
+
+	// The slot may have been posted to again since.
+	__sync_synchronize();
+	return request.sequence == ticket ? status : VS1000UART::STATUSIDLE;
+}
+
+VS1000UART::COMMANDSTATUS VS1000Task::wait(uint16_t ticket, unsigned long timeout)
+{
+	unsigned long start = millis();
+
+	#if defined(ARDUINO_ARCH_ESP32)
+		// Set before checking, so the driver either sees the waiter or the check sees the request finished.
+		Request& request = _requests[ticket % VS1000TASKQUEUESIZE];
+		lock();
+		if (request.sequence == ticket)
+		{
+			request.waiter = xTaskGetCurrentTaskHandle();
+		}
+		unlock();
+		__sync_synchronize();
+	#endif
+
+	VS1000UART::COMMANDSTATUS status;
+	while ((status = getStatus(ticket)) == VS1000UART::STATUSPENDING && millis() - start < timeout)
+	{
+		// Checked again at least every 10 ms in case the wake up was for something else.
+		unsigned long remaining = timeout - (millis() - start);
+		remaining = remaining < 10 ? remaining : 10;
+
+		#if defined(ARDUINO_ARCH_ESP32)
+			// Notified by the driver.
+			ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(remaining) + 1);
+		#else
+			// The driver sends an event each time it finishes requests.
+			best_effort_wfe_or_timeout(make_timeout_time_ms(remaining));
+		#endif
+	}
+
+	#if defined(ARDUINO_ARCH_ESP32)
+		lock();
+		if (request.sequence == ticket)
+		{
+			request.waiter = NULL;
+		}
+		unlock();
+	#endif
+
+	return status;
+}
+
+uint8_t VS1000Task::getVolume()
+{
+	return _volume;
+}
+
+VS1000UART::VOLUMELEVEL VS1000Task::getVolumeLevel()
+{
+	return (VS1000UART::VOLUMELEVEL)_volumeLevel;
+}
+
+bool VS1000Task::isPlaying()
+{
+	return _playing;
+}
+
+bool VS1000Task::isIdle()
+{
+	return _finished == _posted;
+}
+
+void VS1000Task::takeRequests()
+{
+	for (;;)
+	{
+		uint16_t	sequence	= nextSequence(_taken);
+		Request&	request		= _requests[sequence % VS1000TASKQUEUESIZE];
+		if (!request.posted || request.sequence != sequence)
+		{
+			return;
+		}
+
+		// Only read once the posting is seen.
+		__sync_synchronize();
+
+		bool queued;
+		#if VS1000PLAYBYNAME
+		if (request.command == VS1000UART::COMMANDPLAYNAME)
+		{
+			queued = _audio->queuePlayFile(request.fileName);
+		}
+		else
+		#endif
+		if (request.level)
+		{
+			queued = _audio->queueVolumeLevel((VS1000UART::VOLUMELEVEL)request.argument);
+		}
+		else
+		{
+			queued = _audio->queueCommand(request.command, request.argument);
+		}
+
+		if (!queued)
+		{
+			// A full queue is tried again on the next pass.  An idle board that refuses it (held in reset) never will take it.
+			if (!_audio->isIdle())
+			{
+				return;
+			}
+
+			if (_finished != _taken)
+			{
+				finishRequests(_audio->getCommandStatus());
+			}
+		}
+
+		// The slot can be posted to again once it is taken.
+		_taken			= sequence;
+		request.posted	= false;
+
+		if (!queued)
+		{
+			finishRequests(VS1000UART::STATUSFAILED);
+		}
+	}
+}
+
+void VS1000Task::finishRequests(VS1000UART::COMMANDSTATUS status)
+{
+	for (uint16_t sequence = nextSequence(_finished); ; sequence = nextSequence(sequence))
+	{
+		Request& request = _requests[sequence % VS1000TASKQUEUESIZE];
+		if (request.sequence == sequence)
+		{
+			request.status = status;
+		}
+
+		if (sequence == _taken)
+		{
+			break;
+		}
+	}
+
+	// The statuses are written before the finished sequence that makes them readable.
+	__sync_synchronize();
+	_finished = _taken;
+	__sync_synchronize();
+
+	#if defined(ARDUINO_ARCH_ESP32)
+		// The waiters are copied out so they are notified outside the critical section.
+		TaskHandle_t waiters[VS1000TASKQUEUESIZE];
+		lock();
+		for (uint8_t i = 0; i < VS1000TASKQUEUESIZE; i++)
+		{
+			waiters[i] = _requests[i].waiter;
+		}
+		unlock();
+
+		for (uint8_t i = 0; i < VS1000TASKQUEUESIZE; i++)
+		{
+			if (waiters[i] != NULL)
+			{
+				xTaskNotifyGive(waiters[i]);
+			}
+		}
+	#else
+		__sev();
+	#endif
+}
+
+uint16_t VS1000Task::postRequest(VS1000UART::COMMAND command, uint8_t argument, bool level, const char* fileName)
+{
+	lock();
+
+	uint16_t	sequence	= nextSequence(_posted);
+	Request&	request		= _requests[sequence % VS1000TASKQUEUESIZE];
+
+	// The slot is still waiting for the driver, the queue is full.
+	if (request.posted)
+	{
+		unlock();
+		return 0;
+	}
+
+	request.sequence	= sequence;
+	request.command		= command;
+	request.argument	= argument;
+	request.level		= level;
+	request.status		= VS1000UART::STATUSPENDING;
+	#if VS1000PLAYBYNAME
+	if (fileName != NULL)
+	{
+		strncpy(request.fileName, fileName, 11);
+		request.fileName[11] = 0;
+	}
+	#else
+	(void)fileName;
+	#endif
+
+	// The driver doesn't take the lock, so it has to see the request filled in before it sees it posted.
+	__sync_synchronize();
+	request.posted	= true;
+	_posted			= sequence;
+
+	unlock();
+	return sequence;
+}
+
+uint16_t VS1000Task::nextSequence(uint16_t sequence)
+{
+	return sequence == 0xFFFF ? 1 : sequence + 1;
+}
+
+void VS1000Task::lock()
+{
+	#if defined(ARDUINO_ARCH_ESP32)
+		portENTER_CRITICAL(&_lock);
+	#else
+		critical_section_enter_blocking(&_lock);
+	#endif
+}
+
+void VS1000Task::unlock()
+{
+	#if defined(ARDUINO_ARCH_ESP32)
+		portEXIT_CRITICAL(&_lock);
+	#else
+		critical_section_exit(&_lock);
+	#endif
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*! @file VS1000Task.h */
+
+#ifndef VS1000TASK_H
+#define VS1000TASK_H
+
+#include <Arduino.h>
+#include "VS1000UART.h"
+
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_RP2040)
+
+#if defined(ARDUINO_ARCH_ESP32)
+	#include <freertos/FreeRTOS.h>
+	#include <freertos/task.h>
+#else
+	#include <pico/critical_section.h>
+#endif
+
+// Number of requests that can be posted and not yet taken by the driver.  The result of a request is kept until its slot is
+// posted to again.
+#define VS1000TASKQUEUESIZE		8
+
+/// \brief Lets tasks on other cores control an audio board.  One driver owns the VS1000UART and is the only one that calls it: a
+/// FreeRTOS task started by "start" on an ESP32, or "service" called from "loop1" on the second core of an RP2040.  Any other task
+/// posts requests, which never block, and gets a ticket it can check or wait on.  The volume and play state are published by the
+/// driver after each pass, so reading them doesn't touch the chip either.
+///
+/// Posting takes a spin lock for the few instructions that claim and fill a slot.  The RP2040 has no compare and swap, so a lock is
+/// the only way that is safe from both cores.  The driver takes requests without the lock.  Requests go into the command queue of
+/// the audio class as they arrive, so a burst of volume changes is still merged into one.  A ticket finishes when the board has
+/// finished everything it was given, the same as VS1000Group, and its status is how the last of those commands completed.
+///
+/// Only on the ESP32 and RP2040.  The audio class is set up with "begin" and "reset" before the driver starts.
+class VS1000Task
+{
+	private:
+		struct Request
+		{
+			uint16_t								sequence;
+			VS1000UART::COMMAND						command;
+			uint8_t									argument;
+			bool									level;
+			#if VS1000PLAYBYNAME
+			char									fileName[12];
+			#endif
+			volatile bool							posted;
+			volatile VS1000UART::COMMANDSTATUS		status;
+			#if defined(ARDUINO_ARCH_ESP32)
+			TaskHandle_t volatile					waiter;
+			#endif
+		};
+
+	// Constructors.
+	public:
+		/// \brief Constructor.
+		/// \param audio The board to drive.  Not owned by this class, and not to be called by anything but the driver once it starts.
+		VS1000Task(VS1000UART* audio);
+
+	// Driver.
+	public:
+		#if defined(ARDUINO_ARCH_ESP32)
+		/// \brief Starts a task that drives the board.  It services the board every millisecond and sleeps in between.
+		/// \param core Core to run the task on.
+		/// \param priority Priority of the task.
+		/// \return Returns false if the task couldn't be created or is already running.
+		bool start(BaseType_t core = 1, UBaseType_t priority = 2);
+		#endif
+
+		/// \brief Takes posted requests, moves the command engine along, and publishes the results.  Never blocks.  On the RP2040, call
+		/// from "loop1."
+		void service();
+
+	// Posting from any task.
+	public:
+		/// \brief Posts a command.  Merged with other commands the same way as "VS1000UART::queueCommand."
+		/// \param command The command to send.
+		/// \param argument The file number for COMMANDPLAYNUMBER, the volume for COMMANDSETVOLUME, otherwise unused.
+		/// \return Returns the ticket of the request, or 0 if the queue is full.
+		uint16_t post(VS1000UART::COMMAND command, uint8_t argument = 0);
+
+		#if VS1000PLAYBYNAME
+		/// \brief Posts a play by name.  The name is copied.
+		/// \param fileName Track name.
+		/// \return Returns the ticket of the request, or 0 if the queue is full.
+		uint16_t postPlayFile(const char* fileName);
+		#endif
+
+		/// \brief Posts a change to a volume level.
+		/// \param level The level.
+		/// \return Returns the ticket of the request, or 0 if the queue is full.
+		uint16_t postVolumeLevel(VS1000UART::VOLUMELEVEL level);
+
+		/// \brief Gets the status of a request.
+		/// \param ticket The ticket from posting.
+		/// \return Returns STATUSPENDING until the request has finished, or STATUSIDLE if the ticket is too old to know.
+		VS1000UART::COMMANDSTATUS getStatus(uint16_t ticket);
+
+		/// \brief Waits for a request to finish.  The waiting task sleeps, on an ESP32 until the driver notifies it, on an RP2040 until
+		/// the driver signals an event.  Never call from the driver.
+		/// \param ticket The ticket from posting.
+		/// \param timeout Longest time to wait in milliseconds.
+		/// \return Returns how the request completed, or STATUSPENDING if it timed out.
+		VS1000UART::COMMANDSTATUS wait(uint16_t ticket, unsigned long timeout);
+
+	// State published by the driver.
+	public:
+		/// \brief Gets the volume the chip was at after the last pass of the driver.
+		uint8_t getVolume();
+
+		/// \brief Gets the volume level the chip was at after the last pass of the driver.
+		VS1000UART::VOLUMELEVEL getVolumeLevel();
+
+		/// \brief Checks if a track was playing after the last pass of the driver.
+		bool isPlaying();
+
+		/// \brief Checks if every posted request has finished.
+		bool isIdle();
+
+	private:
+		/// \brief Takes the posted requests and queues them on the board.
+		void takeRequests();
+
+		/// \brief Finishes the requests given to the board.
+		void finishRequests(VS1000UART::COMMANDSTATUS status);
+
+		/// \brief Claims and fills the next slot.
+		/// \param level True if the argument is a volume level.
+		/// \param fileName Track name for COMMANDPLAYNAME, otherwise NULL.
+		uint16_t postRequest(VS1000UART::COMMAND command, uint8_t argument, bool level, const char* fileName);
+
+		/// \brief Gets the sequence number after one, skipping 0.
+		static uint16_t nextSequence(uint16_t sequence);
+
+		/// \brief Locks out posting from other tasks and cores.
+		void lock();
+
+		/// \brief Lets other tasks and cores post again.
+		void unlock();
+
+		#if defined(ARDUINO_ARCH_ESP32)
+		/// \brief Body of the task started by "start."
+		static void run(void* task);
+		#endif
+
+	private:
+		VS1000UART*					_audio;
+		Request						_requests[VS1000TASKQUEUESIZE];
+
+		// Sequence numbers of the last request posted, taken by the driver, and finished.  Only posting changes the first, only the
+		// driver changes the others.  0 is never used, so it can mean no ticket.  A slot is free again once the driver has taken it.
+		volatile uint16_t			_posted;
+		volatile uint16_t			_taken;
+		volatile uint16_t			_finished;
+
+		// Published by the driver.
+		volatile uint8_t			_volume;
+		volatile uint8_t			_volumeLevel;
+		volatile bool				_playing;
+
+		#if defined(ARDUINO_ARCH_ESP32)
+		portMUX_TYPE				_lock;
+		TaskHandle_t				_task;
+		#else
+		critical_section_t			_lock;
+		#endif
+};
+
+#endif
+
+#endif
@@ -0,0 +1,160 @@
+/*! \file VS1000Tokenizer.cpp  */
+
+#include "VS1000Tokenizer.h"
+
+// Keywords, in the order of KEYWORD.  The search restarts at the first character of a keyword on a mismatch, which is only right
+// because none of them repeat their first character.
+static const char _keywords[VS1000Tokenizer::KEYWORDCOUNT][12] PROGMEM =
+{
+	"play",
+	"NoFile",
+	"Files",
+	"Adafruit FX"
+};
+
+VS1000Tokenizer::VS1000Tokenizer(char* buffer, uint8_t bufferSize) :
+	_buffer(buffer),
+	_bufferSize(bufferSize)
+{
+	startLine();
+}
+
+bool VS1000Tokenizer::add(char character)
+{
+	// Dropped before starting the next line, so a "\r" after the "\n" doesn't throw away the line that just ended.
+	if (character == '\r')
+	{
+		return false;
+	}
+
+	if (_ended)
+	{
+		startLine();
+	}
+
+	if (character == '\n')
+	{
+		_buffer[_length < _bufferSize ? _length : _bufferSize - 1] = 0;
+		_ended = true;
+		return true;
+	}
+
+	// Numbers are runs of digits.  A run is added up as it comes in and the first and last runs are kept.
+	if (isdigit(character))
+	{
+		if (!_inNumber)
+		{
+			_inNumber		= true;
+			_lastNumber		= 0;
+			if (_length == 0)
+			{
+				_startsWithNumber = true;
+			}
+		}
+
+		_lastNumber = _lastNumber * 10 + (character - '0');
+		if (_numberCount == 0)
+		{
+			_firstNumber = _lastNumber;
+		}
+	}
+	else if (_inNumber)
+	{
+		_inNumber = false;
+		_numberCount++;
+	}
+
+	matchKeywords(character);
+
+	// Characters past the end of the buffer are dropped, the line is still ended by the new line.
+	if (_length < _bufferSize - 1)
+	{
+		_buffer[_length] = character;
+	}
+	if (_length < 255)
+	{
+		_length++;
+	}
+
+	return false;
+}
+
+void VS1000Tokenizer::reset()
+{
+	startLine();
+}
+
+bool VS1000Tokenizer::inLine()
+{
+	return !_ended && _length > 0;
+}
+
+uint8_t VS1000Tokenizer::length()
+{
+	return _length;
+}
+
+bool VS1000Tokenizer::startsWithNumber()
+{
+	return _startsWithNumber;
+}
+
+uint8_t VS1000Tokenizer::numberCount()
+{
+	// A number that runs to the end of the line hasn't been counted yet.
+	return _numberCount + (_inNumber ? 1 : 0);
+}
+
+uint32_t VS1000Tokenizer::firstNumber()
+{
+	return _firstNumber;
+}
+
+uint32_t VS1000Tokenizer::lastNumber()
+{
+	return _lastNumber;
+}
+
+bool VS1000Tokenizer::found(KEYWORD keyword)
+{
+	return _keywordsFound & (1 << keyword);
+}
+
+void VS1000Tokenizer::startLine()
+{
+	_length				= 0;
+	_ended				= false;
+	_inNumber			= false;
+	_startsWithNumber	= false;
+	_numberCount		= 0;
+	_firstNumber		= 0;
+	_lastNumber			= 0;
+	_keywordsFound		= 0;
+	memset(_keywordMatched, 0, sizeof(_keywordMatched));
+}
+
+void VS1000Tokenizer::matchKeywords(char character)
+{
+	for (uint8_t keyword = 0; keyword < KEYWORDCOUNT; keyword++)
+	{
+		if (_keywordsFound & (1 << keyword))
+		{
+			continue;
+		}
+
+		const char* text = _keywords[keyword];
+		if (character != (char)pgm_read_byte(text + _keywordMatched[keyword]))
+		{
+			_keywordMatched[keyword] = character == (char)pgm_read_byte(text) ? 1 : 0;
+		}
+		else
+		{
+			_keywordMatched[keyword]++;
+		}
+
+		if (pgm_read_byte(text + _keywordMatched[keyword]) == 0)
+		{
+			_keywordsFound |= 1 << keyword;
+		}
+	}
+}
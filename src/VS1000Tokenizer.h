@@ -0,0 +1,86 @@
+/*! @file VS1000Tokenizer.h */
+
+#ifndef VS1000TOKENIZER_H
+#define VS1000TOKENIZER_H
+
+#include <Arduino.h>
+
+/// \brief Puts together lines from the audio chip one byte at a time and parses them as the bytes arrive, so each byte is only looked
+/// at once and a line never has to be scanned again.
+///
+/// The numbers on the line and the keywords the answers are recognized by are picked out on the way in.  The characters are also
+/// kept in a caller supplied buffer for the parts that need the text, like file names.  What was found stays valid until the first
+/// byte of the next line.
+class VS1000Tokenizer
+{
+	public:
+		/// \brief Words searched for anywhere in a line.
+		enum KEYWORD : uint8_t
+		{
+			KEYWORDPLAY,
+			KEYWORDNOFILE,
+			KEYWORDFILES,
+			KEYWORDBANNER,
+			KEYWORDCOUNT
+		};
+
+	// Constructors.
+	public:
+		/// \brief Constructor.
+		/// \param buffer Buffer the line is stored in.  Characters that don't fit are still parsed but not stored.
+		/// \param bufferSize Size of the buffer, including the terminator.
+		VS1000Tokenizer(char* buffer, uint8_t bufferSize);
+
+	// Parsing.
+	public:
+		/// \brief Adds a byte.  Carriage returns are dropped, so lines ending in "\r\n" and "\n\r" look the same.
+		/// \param character Byte received.
+		/// \return Returns true when the byte ended a line.  The line can be empty.
+		bool add(char character);
+
+		/// \brief Throws away the part of a line collected so far.
+		void reset();
+
+		/// \brief Checks if part of a line has come in and the line hasn't ended yet.
+		bool inLine();
+
+		/// \brief Gets the number of characters in the line, counting ones that didn't fit in the buffer.
+		uint8_t length();
+
+		/// \brief Checks if the line started with a digit.
+		bool startsWithNumber();
+
+		/// \brief Gets how many numbers were in the line.  A number is a run of digits.
+		uint8_t numberCount();
+
+		/// \brief Gets the first number in the line, or 0 if there were none.
+		uint32_t firstNumber();
+
+		/// \brief Gets the last number in the line, or 0 if there were none.
+		uint32_t lastNumber();
+
+		/// \brief Checks if a keyword appeared in the line.
+		bool found(KEYWORD keyword);
+
+	private:
+		/// \brief Starts a new line.
+		void startLine();
+
+		/// \brief Moves the keyword searches along by one character.
+		void matchKeywords(char character);
+
+	private:
+		char*						_buffer;
+		uint8_t						_bufferSize;
+		uint8_t						_length;
+		bool						_ended;
+		bool						_inNumber;
+		bool						_startsWithNumber;
+		uint8_t						_numberCount;
+		uint32_t					_firstNumber;
+		uint32_t					_lastNumber;
+		uint8_t						_keywordMatched[KEYWORDCOUNT];
+		uint8_t						_keywordsFound;
+};
+
+#endif
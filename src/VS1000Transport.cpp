@@ -0,0 +1,103 @@
+/*! \file VS1000Transport.cpp  */
+
+#include "VS1000Transport.h"
+
+VS1000Transport::VS1000Transport() :
+	_receiveStart(0),
+	_receiveCount(0),
+	_transmitStart(0),
+	_transmitCount(0)
+{
+}
+
+void VS1000Transport::update()
+{
+	// Take everything the hardware has, so long as there is room.
+	while (_receiveCount < VS1000RECEIVEBUFFERSIZE)
+	{
+		int byte = receiveByte();
+		if (byte < 0)
+		{
+			break;
+		}
+
+		_receiveBuffer[(_receiveStart + _receiveCount) % VS1000RECEIVEBUFFERSIZE] = byte;
+		_receiveCount++;
+	}
+
+	// Only hand over as many bytes as the hardware can take without waiting.
+	uint8_t room = transmitRoom();
+	while (_transmitCount > 0 && room > 0)
+	{
+		transmitByte(_transmitBuffer[_transmitStart]);
+		_transmitStart = (_transmitStart + 1) % VS1000TRANSMITBUFFERSIZE;
+		_transmitCount--;
+		room--;
+	}
+}
+
+int VS1000Transport::read()
+{
+	if (_receiveCount == 0)
+	{
+		update();
+
+		if (_receiveCount == 0)
+		{
+			return -1;
+		}
+	}
+
+	uint8_t byte	= _receiveBuffer[_receiveStart];
+	_receiveStart	= (_receiveStart + 1) % VS1000RECEIVEBUFFERSIZE;
+	_receiveCount--;
+
+	return byte;
+}
+
+bool VS1000Transport::write(const uint8_t* data, uint8_t length)
+{
+	if (length > transmitSpace())
+	{
+		return false;
+	}
+
+	for (uint8_t i = 0; i < length; i++)
+	{
+		_transmitBuffer[(_transmitStart + _transmitCount) % VS1000TRANSMITBUFFERSIZE] = data[i];
+		_transmitCount++;
+	}
+
+	// Start sending right away if the hardware has room.
+	update();
+
+	return true;
+}
+
+uint8_t VS1000Transport::transmitSpace()
+{
+	return VS1000TRANSMITBUFFERSIZE - _transmitCount;
+}
+
+uint8_t VS1000Transport::discardReceived()
+{
+	uint16_t discarded	= _receiveCount;
+	_receiveCount		= 0;
+
+	while (receiveByte() >= 0)
+	{
+		discarded++;
+	}
+
+	return discarded > 255 ? 255 : discarded;
+}
+
+bool VS1000Transport::setBaudRate(unsigned long)
+{
+	return false;
+}
+
+unsigned long VS1000Transport::getBaudRate()
+{
+	return 0;
+}
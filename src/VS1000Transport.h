@@ -0,0 +1,80 @@
+/*! @file VS1000Transport.h */
+
+#ifndef VS1000TRANSPORT_H
+#define VS1000TRANSPORT_H
+
+#include <Arduino.h>
+
+// Size of the receive ring buffer.  Must hold the answers to a full window of pipelined volume steps (8 answers of up to 5 bytes).
+#define VS1000RECEIVEBUFFERSIZE		48
+
+// Size of the transmit buffer.  Must hold the longest command, play by name, which is 13 bytes.
+#define VS1000TRANSMITBUFFERSIZE	16
+
+/// \brief Connection to the audio chip.  Received bytes are collected into a ring buffer the command engine reads from, and bytes to
+/// send are buffered and handed to the hardware only as fast as it can take them, so writing never blocks.
+///
+/// Derived classes connect the buffers to the hardware.
+class VS1000Transport
+{
+	// Constructors.
+	public:
+		/// \brief Constructor.
+		VS1000Transport();
+
+		/// \brief Destructor.
+		virtual ~VS1000Transport() {}
+
+	// Interface used by the command engine.
+	public:
+		/// \brief Moves received bytes into the receive buffer and buffered bytes out to the hardware.
+		void update();
+
+		/// \brief Reads one received byte.
+		/// \return Returns the byte, or -1 if nothing has been received.
+		int read();
+
+		/// \brief Buffers bytes to send.  Either all the bytes are buffered or none are.
+		/// \param data Bytes to send.
+		/// \param length Number of bytes.
+		/// \return Returns false if there isn't room in the transmit buffer.
+		bool write(const uint8_t* data, uint8_t length);
+
+		/// \brief Gets the room left in the transmit buffer.
+		uint8_t transmitSpace();
+
+		/// \brief Throws away everything received so far.
+		/// \return Returns the number of bytes thrown away, up to 255.
+		uint8_t discardReceived();
+
+		/// \brief Changes the baud rate of the connection.  Anything already handed to the hardware is sent at the old rate first.
+		/// \param baudRate Baud rate.
+		/// \return Returns false if the connection can't change its rate, which is the default.
+		virtual bool setBaudRate(unsigned long baudRate);
+
+		/// \brief Gets the baud rate of the connection.
+		/// \return Returns the baud rate, or 0 if it isn't known, which is the default.
+		virtual unsigned long getBaudRate();
+
+	// Hardware interface.
+	protected:
+		/// \brief Reads one byte from the hardware.
+		/// \return Returns the byte, or -1 if nothing is waiting.
+		virtual int receiveByte() = 0;
+
+		/// \brief Gets how many bytes the hardware can take right now without blocking.
+		virtual uint8_t transmitRoom() = 0;
+
+		/// \brief Sends one byte to the hardware.
+		virtual void transmitByte(uint8_t byte) = 0;
+
+	private:
+		uint8_t						_receiveBuffer[VS1000RECEIVEBUFFERSIZE];
+		uint8_t						_receiveStart;
+		uint8_t						_receiveCount;
+		uint8_t						_transmitBuffer[VS1000TRANSMITBUFFERSIZE];
+		uint8_t						_transmitStart;
+		uint8_t						_transmitCount;
+};
+
+#endif
@@ -31,45 +31,260 @@
 
 #include "VS1000UART.h"
 
+#if VS1000PERSISTENCE
+	#include "VS1000EEPROMStorage.h"
+#endif
+
+#if defined(__AVR__)
+	#include <avr/sleep.h>
+#endif
+
+// Interrupt handlers have to be in RAM on the ESP32 and ESP8266, flash can't be read while it is being written.
+#if defined(IRAM_ATTR)
+	#define VS1000INTERRUPTHANDLER	IRAM_ATTR
+#else
+	#define VS1000INTERRUPTHANDLER
+#endif
+
+#if VS1000STATISTICS
+	#include "VS1000Statistics.h"
+#endif
+
 // Initialize static members.
-const uint8_t		VS1000UART::_lineBufferSize 			= 80;
+const uint8_t		VS1000UART::_defaultLineBufferSize 		= 80;
 const uint8_t		VS1000UART::_chipMinVolume				= 0;
 const uint8_t		VS1000UART::_chipMaxVolume				= 204;
+const uint16_t		VS1000UART::_defaultTimeouts[]			= { 200, 200, 500, 300, 1000 };
+const uint8_t		VS1000UART::_minimumAdaptiveTimeout		= 20;
+const uint8_t		VS1000UART::_lateAnswerTime				= 100;
+const uint8_t		VS1000UART::_chipVolumeStep				= 2;
+const uint8_t		VS1000UART::_volumeStepWindow			= 8;
+const uint8_t		VS1000UART::_resetHoldTime				= 15;
+const uint8_t		VS1000UART::_volumeNotSaved				= 1;
+const uint8_t		VS1000UART::_activityStartTime			= 100;
+const uint16_t		VS1000UART::_playlistCheckInterval		= 1000;
+const uint8_t		VS1000UART::_playlistEndCheckInterval	= 200;
+const uint8_t		VS1000UART::_playlistNotStarted			= 255;
+const uint16_t		VS1000UART::_recoveryInterval			= 1000;
+#if VS1000PERSISTENCE
+const uint8_t		VS1000UART::_savedFileEntrySize			= 8;
+const uint8_t		VS1000UART::_stateVersion				= 2;
+const uint16_t		VS1000UART::_minimumStateSaveDelay		= 1000;
+const uint8_t		VS1000UART::_statePlaying				= 0x01;
+const uint8_t		VS1000UART::_statePaused				= 0x02;
+const uint8_t		VS1000UART::_statePlaylist				= 0x04;
+#endif
+const uint32_t		VS1000UART::_probeBaudRates[] PROGMEM	= { 115200, 57600, 38400, 19200, 9600 };
+// How far each level is between the minimum and maximum volume, out of 255.  Each level is 4 dB above the one below, which makes
+// 36 dB from VOLUME1 to VOLUME10.  VOLUME0 stays at the minimum volume.
+static const uint8_t _logarithmicCurve[VS1000UART::VOLUME10 + 1] PROGMEM = { 0, 4, 6, 10, 16, 26, 40, 64, 102, 161, 255 };
+
+VS1000UART*			VS1000UART::_activityInstances[VS1000UART::_activityInterruptCount];
 
 VS1000UART::VS1000UART(Stream* chipStream, int8_t resetPin) :
-	_chipStream(chipStream),
-	_resetPin(resetPin),
-	_minimumVolume(_chipMinVolume),
-	_maximumVolume(_chipMaxVolume),
-	_volumeIncrement((_maximumVolume - _minimumVolume)/10.0),
-	_minimumLevel(VOLUME0),
-	_maximumLevel(VOLUME10),
-	_persistentVolume(false),
-	_memoryAddress(0)
+	VS1000UART(new VS1000StreamTransport(chipStream), resetPin)
 {
-	_lineBuffer = new char[_lineBufferSize];
+	_ownsTransport = true;
 }
 
+#if VS1000PERSISTENCE
 VS1000UART::VS1000UART(Stream* chipStream, int8_t resetPin, int memoryAddress) :
-	_chipStream(chipStream),
+	VS1000UART(new VS1000StreamTransport(chipStream), resetPin, memoryAddress)
+{
+	_ownsTransport = true;
+}
+#endif
+
+VS1000UART::VS1000UART(VS1000Transport* transport, int8_t resetPin) :
+	#if VS1000PERSISTENCE
+	VS1000UART(transport, resetPin, -1)
+	#else
+	VS1000UART(transport, resetPin, new char[_defaultLineBufferSize], _defaultLineBufferSize, NULL, -1, NULL)
+	#endif
+{
+	#if !VS1000PERSISTENCE
+	_ownsLineBuffer = true;
+	#endif
+}
+
+#if VS1000PERSISTENCE
+VS1000UART::VS1000UART(VS1000Transport* transport, int8_t resetPin, int memoryAddress) :
+	VS1000UART(transport, resetPin, new char[_defaultLineBufferSize], _defaultLineBufferSize, &VS1000EEPROM, memoryAddress, NULL)
+{
+	_ownsLineBuffer = true;
+}
+#endif
+
+VS1000UART::VS1000UART(VS1000Transport* transport, int8_t resetPin, char* lineBuffer, uint8_t lineBufferSize, VS1000Storage* storage, int memoryAddress, DebugOutput debugOutput) :
+	_transport(transport),
+	_ownsTransport(false),
 	_resetPin(resetPin),
+	_lineBuffer(lineBuffer),
+	_ownsLineBuffer(false),
+	#if VS1000PERSISTENCE
+	_storage(storage),
+	#endif
+	#if VS1000DEBUG
+	_debugOutput(debugOutput),
+	#endif
 	_minimumVolume(_chipMinVolume),
 	_maximumVolume(_chipMaxVolume),
-	_volumeIncrement((_maximumVolume - _minimumVolume)/10.0),
+	_volumeCurve(NULL),
 	_minimumLevel(VOLUME0),
 	_maximumLevel(VOLUME10),
-	_persistentVolume(true),
-	_memoryAddress(memoryAddress)
+	_volume(0),
+	#if VS1000PERSISTENCE
+	_persistentVolume(storage != NULL && memoryAddress >= 0),
+	_memoryAddress(memoryAddress),
+	_volumeSaveDelay(0),
+	_volumeChangeTime(0),
+	_volumeDirty(false),
+	_volumeMemorySlots(8),
+	_volumeSlot(0),
+	_volumeSequence(0),
+	_savedVolume(0),
+	_stateAddress(-1),
+	_stateSlots(1),
+	_stateSlot(0),
+	_stateSequence(0),
+	_stateRestored(false),
+	_stateDirty(false),
+	_stateChangeTime(0),
+	#endif
+	_commandQueueStart(0),
+	_commandQueueCount(0),
+	_activeCommand(COMMANDNONE),
+	_activeArgument(0),
+	_commandStatus(STATUSIDLE),
+	_commandStartTime(0),
+	_workaroundSent(false),
+	_playArmed(false),
+	#if VS1000STATISTICS
+	_statistics(NULL),
+	_commandStartMicros(0),
+	#endif
+	_tokenizer(lineBuffer, lineBufferSize),
+	#if VS1000PLAYBYNAME && VS1000LISTING
+	_playLookedUp(false),
+	_checkPlayName(false),
+	#endif
+	_commandCallback(NULL),
+	_eventCallback(NULL),
+	_lateCommand(COMMANDNONE),
+	_lateTime(0),
+	_receiveTime(0),
+	_unsolicitedCount(0),
+	_unsolicitedBytes(0),
+	_currentTime(0),
+	_totalTime(0),
+	#if VS1000PROGRESS
+	_remainingBytes(0),
+	_totalBytes(0),
+	#endif
+	_adaptiveTimeouts(false),
+	#if VS1000PROGRESS
+	_progressRefresh(1000),
+	_progressValid(false),
+	_progressTime(0),
+	_progressPosition(0),
+	_sizeValid(false),
+	_sizeTime(0),
+	_byteRate(0),
+	#endif
+	_volumeStepsToSend(0),
+	_volumeStepsInFlight(0),
+	_pipelineVolume(0),
+	_pipelineStartVolume(0),
+	_resetTimeout(2000),
+	_bootVolume(_chipMaxVolume),
+	_resetHolding(false),
+	_bootBannerFound(false),
+	_bootLineCount(0),
+	_bootTime(0),
+	_bootFileCount(-1),
+	_powerSaving(false),
+	_heldInReset(false),
+	_heldVolume(0),
+	_baudProbing(false),
+	_watchdogTimeouts(0),
+	_consecutiveTimeouts(0),
+	_chipDown(false),
+	_recovering(false),
+	_recoveryTime(0),
+	_baudAttempt(0),
+	_probeStartRate(0),
+	#if VS1000LISTING
+	_fileTable(NULL),
+	_fileTableCapacity(0),
+	_fileTableCount(0),
+	_fileTableReady(false),
+	_fileTableKept(false),
+	_trackLengthWanted(false),
+	#if VS1000PERSISTENCE
+	_fileTableAddress(-1),
+	#endif
+	_listedFileCount(0),
+	_fileCallback(NULL),
+	_fileCallbackStopped(false),
+	_listFileNames(NULL),
+	_listFileSizes(NULL),
+	_listArrayLength(0),
+	#endif
+	_activityPin(-1),
+	_activityInterrupt(false),
+	_activityChanged(false),
+	_playing(false),
+	_paused(false),
+	_playStartTime(0),
+	_lastTrack(0),
+	_trackEndCallback(NULL),
+	_playlist(NULL),
+	_playlistLength(0),
+	_playlistPosition(_playlistNotStarted),
+	_playlistMode(PLAYLISTONCE),
+	_playlistActive(false),
+	_playlistNext(false),
+	_playlistAdvancing(false),
+	_playlistCheckTime(0),
+	_playlistCheckDelay(0),
+	_trackCallback(NULL)
 {
-	_lineBuffer = new char[_lineBufferSize];
+	for (uint8_t i = 0; i < TIMEOUTCOUNT; i++)
+	{
+		_timeouts[i]			= _defaultTimeouts[i];
+		_averageResponse[i]		= 0;
+		_responseDeviation[i]	= 0;
+	}
+
+	#if !VS1000PERSISTENCE
+	(void)storage;
+	(void)memoryAddress;
+	#endif
+	#if !VS1000DEBUG
+	(void)debugOutput;
+	#endif
 }
 
 VS1000UART::~VS1000UART()
 {
-	if (_lineBuffer)
+	for (uint8_t i = 0; i < _activityInterruptCount; i++)
+	{
+		if (_activityInstances[i] == this)
+		{
+			detachInterrupt(digitalPinToInterrupt(_activityPin));
+			_activityInstances[i] = NULL;
+		}
+	}
+
+	if (_ownsLineBuffer)
 	{
 		delete[] _lineBuffer;
 	}
+
+	if (_ownsTransport)
+	{
+		delete _transport;
+	}
 }
 
 void VS1000UART::setMinimumVolume(uint8_t minimumVolume)
@@ -99,204 +314,311 @@ void VS1000UART::setMaximumLevel(VOLUMELEVEL volumeLevel)
 	_maximumLevel = volumeLevel;
 }
 
-void VS1000UART::begin()
+void VS1000UART::setVolumeCurve(VOLUMECURVE curve)
 {
-	_chipStream->setTimeout(500);
+	// The linear curve is worked out exactly instead of from a table.
+	_volumeCurve = curve == CURVELOGARITHMIC ? _logarithmicCurve : NULL;
+}
 
-	// The reset pin is connected to Vcc.  By switching to input, we will let the reset be pulled to Vcc.
-	pinMode(_resetPin, INPUT);
+void VS1000UART::setVolumeCurve(const uint8_t* curve)
+{
+	_volumeCurve = curve;
+}
 
-	// Calculate volume increment based on volume and level settings.
-	_volumeIncrement = ((float)_maximumVolume - _minimumVolume) / (_maximumLevel - _minimumLevel);
-	synchVolumes();
+#if VS1000PERSISTENCE
+void VS1000UART::setVolumeSaveDelay(unsigned int delay)
+{
+	_volumeSaveDelay = delay;
 }
 
-bool VS1000UART::reset()
+void VS1000UART::setVolumeMemorySlots(uint8_t slots)
 {
-	// Reset by bringing the reset pin low.  First we have to switch the pin to output.  Then pull it low.
-	pinMode(_resetPin, OUTPUT);
-	digitalWrite(_resetPin, LOW);
-	delay(15);
+	_volumeMemorySlots = slots > 0 ? slots : 1;
+}
+#endif
 
-	// Swith the pin back to input.  The reset pin is connected to Vcc.  By switching to input, we will let the
-	// reset be pulled back to Vcc.  The chip may not run at the same voltage as the Arduino so we don't control it
-	// with the Arduino.
-	pinMode(_resetPin, INPUT);
+void VS1000UART::setActivityPin(uint8_t activityPin)
+{
+	_activityPin = activityPin;
+	pinMode(_activityPin, INPUT);
 
-	// Give a bit of time to boot up.
-	delay(1000);
+	if (digitalPinToInterrupt(_activityPin) == NOT_AN_INTERRUPT)
+	{
+		return;
+	}
 
-	// Eat new line.
-	readLine();
+	// Interrupt handlers can't be passed the instance, so each instance takes a free handler.  When they are used up, the pin is read by "poll."
+	static void (* const handlers[_activityInterruptCount])() = { activityInterrupt0, activityInterrupt1, activityInterrupt2, activityInterrupt3 };
+	for (uint8_t i = 0; i < _activityInterruptCount; i++)
+	{
+		if (_activityInstances[i] == NULL)
+		{
+			_activityInstances[i]	= this;
+			_activityInterrupt		= true;
+			attachInterrupt(digitalPinToInterrupt(_activityPin), handlers[i], CHANGE);
+			return;
+		}
+	}
+}
 
-	#if VS1000DEBUGLEVEL > 0
-		Serial.println();
-		Serial.print(F("Audio chip: "));
-		Serial.println(_lineBuffer);
-	#endif
+void VS1000UART::setTrackEndCallback(TrackEndCallback callback)
+{
+	_trackEndCallback = callback;
+}
 
-	// "Adafruit FX Sound Board 9/10/14"
-	readLine();
+#if VS1000STATISTICS
+void VS1000UART::setStatistics(VS1000Statistics* statistics)
+{
+	_statistics = statistics;
+}
+#endif
 
-	#if VS1000DEBUGLEVEL > 0
-		Serial.print(F("Audio chip: "));
-		Serial.println(_lineBuffer);
-	#endif
+void VS1000UART::setResetTimeout(unsigned int timeout)
+{
+	_resetTimeout = timeout;
+}
+
+void VS1000UART::setBootVolume(int16_t volume)
+{
+	_bootVolume = volume > _chipMaxVolume ? _chipMaxVolume : volume;
+}
+
+void VS1000UART::useBaudProbing(bool probe)
+{
+	_baudProbing = probe;
+}
+
+void VS1000UART::usePowerSaving(bool powerSaving)
+{
+	_powerSaving = powerSaving;
+}
+
+void VS1000UART::useWatchdog(uint8_t timeouts)
+{
+	_watchdogTimeouts = timeouts;
+}
+
+void VS1000UART::setTimeout(TIMEOUTCLASS timeoutClass, unsigned int timeout)
+{
+	_timeouts[timeoutClass] = timeout;
+}
+
+unsigned int VS1000UART::getTimeout(TIMEOUTCLASS timeoutClass)
+{
+	// The set time out is used until something has been measured.
+	if (!_adaptiveTimeouts || timeoutClass == TIMEOUTLIST || _averageResponse[timeoutClass] == 0)
+	{
+		return _timeouts[timeoutClass];
+	}
 
-	if (!strstr(_lineBuffer, "Adafruit FX Sound Board"))
+	unsigned int timeout = (_averageResponse[timeoutClass] >> 3) + _responseDeviation[timeoutClass];
+	if (timeout < _minimumAdaptiveTimeout)
 	{
-		//return false;
+		timeout = _minimumAdaptiveTimeout;
 	}
 
-	delay(250);
+	return timeout < _timeouts[timeoutClass] ? timeout : _timeouts[timeoutClass];
+}
 
-	readLine();
-	#if VS1000DEBUGLEVEL > 0
-		Serial.print(F("Audio chip: "));
-		Serial.println(_lineBuffer);
-	#endif
+void VS1000UART::useAdaptiveTimeouts(bool adaptive)
+{
+	_adaptiveTimeouts = adaptive;
+}
+
+#if VS1000PROGRESS
+void VS1000UART::setProgressRefresh(unsigned int interval)
+{
+	_progressRefresh = interval;
+}
+#endif
 
-	readLine();
-	#if VS1000DEBUGLEVEL > 0
-		Serial.print(F("Audio chip: "));
-		Serial.println(_lineBuffer);
+#if VS1000LISTING
+void VS1000UART::useFileTable(FileEntry* fileTable, uint8_t capacity)
+{
+	_fileTable			= fileTable;
+	_fileTableCapacity	= capacity;
+	#if VS1000PERSISTENCE
+	_fileTableAddress	= -1;
 	#endif
+}
 
-	// After restarting the chip, the volumes need to by synchronized.
-	synchVolumes();
+#if VS1000PERSISTENCE
+void VS1000UART::useFileTable(FileEntry* fileTable, uint8_t capacity, int memoryAddress)
+{
+	useFileTable(fileTable, capacity);
+	_fileTableAddress = memoryAddress;
+}
+#endif
+#endif
 
-	return true;
+void VS1000UART::begin()
+{
+	// The reset pin is connected to Vcc.  By switching to input, we will let the reset be pulled to Vcc.
+	pinMode(_resetPin, INPUT);
+
+	// Calculate the volume of each level based on volume and level settings.
+	buildLevelTable();
+
+	// The volume isn't asked for or restored here, the reset that follows does both again once the chip has booted.
+}
+
+bool VS1000UART::reset()
+{
+	// The engine also queues the volume synch once the chip has booted, so when idle the chip is ready to use.
+	return runCommand(COMMANDRESET);
+}
+
+unsigned long VS1000UART::getBootTime()
+{
+	return _bootTime;
+}
+
+bool VS1000UART::bootBannerFound()
+{
+	return _bootBannerFound;
+}
+
+unsigned long VS1000UART::getBaudRate()
+{
+	return _transport->getBaudRate();
 }
 
+#if VS1000LISTING
 uint8_t VS1000UART::listFiles(char fileNames[][12], uint32_t fileSizes[], uint8_t arrayLength)
 {
-	sendCommand(F("L\n"));
-
-	// Reset number of files.  The "_numberOfFiles" is used in the function to index in to the "_fileNames"
-	// and "_fileSizes" array.  Therefore, the number of filex must be incremented after all the other work is done
-	// since the number of files is one less than the index of the file in the array (arrays are zero based).
-	uint8_t numberOfFiles = 0;
-
-	// Loop so long as were are getting new lines back and we haven't exceded our file limit.  The readLine function will return
-	// a zero when it does not read anything.
-	while (readLine() && numberOfFiles < arrayLength)
-	{
-		// File names are 8.3 without the separating dot.
-		// Line returned is composed of file name, tab, zero padded right justified file size.
-		// Example: 04LATCHWAV	0000051892
-		// [0]	- Name start.
-		// [10]	- Last name character.
-		// [11]	- Tab.
-		// [12]	- First size digit.
-		// [21]	- Last size digit.
-		// Copy over the file name.  Then terminate the string in the twelveth character (position [11]).
-		memcpy(fileNames[numberOfFiles], _lineBuffer, 11);
-		fileNames[numberOfFiles][11] = 0;
-
-		// Parse out the file size after the name + tab (tab is 12th character ).
-		fileSizes[numberOfFiles] = 0;
-		for (uint8_t i = 12; i < 22; i++)
-		{
-			char character = _lineBuffer[i];
-
-			// This shouldn't be needed unless garabage got transmitted.
-			if (!isdigit(character))
-			{
-				break;
-			}
+	// Like "runCommand," fails right away while the chip is down.
+	if (_chipDown)
+	{
+		return 0;
+	}
+	waitForIdle();
 
-			// Essentially, this moves the decimal place and adds in the new digit read.  The file size is right justified, but the
-			// left is padded with zeros, so the file size will just be zero until we hit the first significant digit.
-			fileSizes[numberOfFiles] *= 10;
-			fileSizes[numberOfFiles] += atoi(&character);
-		}
+	// The arrays are only handed over once the listing is queued.  If it is refused, they are never seen again, they might not
+	// outlive this call.  The destinations are cleared when the listing is done, whether it worked or not.
+	if (_fileCallback || _listFileNames || !queueCommand(COMMANDLISTFILES))
+	{
+		return 0;
+	}
+	_listFileNames		= fileNames;
+	_listFileSizes		= fileSizes;
+	_listArrayLength	= arrayLength;
 
-		// Now that we are done with the work, we increment the counter.  Don't do this sooner as it is used to index the other arrays.
-		numberOfFiles++;
+	// The listing is always read to the end so nothing is left in the stream to confuse the next command.
+	waitForIdle();
+	if (_commandStatus != STATUSSUCCESS)
+	{
+		return 0;
 	}
 
-	return numberOfFiles;
+	return _listedFileCount < arrayLength ? _listedFileCount : arrayLength;
 }
 
-bool VS1000UART::playFile(uint8_t fileNumber)
+uint8_t VS1000UART::listFiles(FileCallback callback)
 {
-	sendCommand(F("#"));
-	_chipStream->println(fileNumber);
+	if (_chipDown)
+	{
+		return 0;
+	}
+	waitForIdle();
 
-	// Eat return.
-	readLine();
-	readLine();
+	if (!queueListFiles(callback))
+	{
+		return 0;
+	}
 
-	// Check we got "play" back.
-	if (strstr(_lineBuffer, "play") == 0)
+	// Return when the callback is done with the listing.  Anything after that is drained by "poll" in the background.
+	while (!isIdle() && !_fileCallbackStopped)
 	{
-		return false;
+		poll();
 	}
 
-	// Check the # is correct.
-	int playing = atoi(_lineBuffer + 5);
+	return _listedFileCount;
+}
+#endif
+
+bool VS1000UART::playFile(uint8_t fileNumber)
+{
+	return runCommand(COMMANDPLAYNUMBER, fileNumber);
+}
 
-	if (fileNumber != playing)
+#if VS1000PLAYBYNAME
+bool VS1000UART::playFile(const char* fileName)
+{
+	if (_chipDown)
 	{
 		return false;
 	}
+	waitForIdle();
 
-	return true;
+	if (!queuePlayFile(fileName))
+	{
+		return false;
+	}
+
+	waitForIdle();
+	return _commandStatus == STATUSSUCCESS;
 }
+#endif
 
-bool VS1000UART::playFile(char* fileName)
+#if VS1000LISTING
+int16_t VS1000UART::findFile(const char* fileName)
 {
-	sendCommand(F("P"));
-	_chipStream->println(fileName);
+	if (!_fileTableReady)
+	{
+		return -1;
+	}
 
-	// Eat return.
-	readLine();
-	readLine();
+	uint16_t	hash	= hashFileName(fileName);
+	int16_t		found	= -1;
 
-	// Check we got "play" back.
-	if (strstr(_lineBuffer, "play") == 0)
+	for (uint8_t i = 0; i < _fileTableCount; i++)
 	{
-		return false;
+		if (_fileTable[i].nameHash == hash)
+		{
+			// Two names with the same hash can't be told apart.
+			if (found >= 0)
+			{
+				return -1;
+			}
+			found = i;
+		}
 	}
 
-	return true;
+	return found;
+}
+
+bool VS1000UART::fileTableReady()
+{
+	return _fileTableReady;
+}
+
+uint8_t VS1000UART::getFileTableCount()
+{
+	return _fileTableCount;
 }
 
+const VS1000UART::FileEntry* VS1000UART::getFileEntry(uint8_t fileNumber)
+{
+	return _fileTableReady && fileNumber < _fileTableCount ? &_fileTable[fileNumber] : NULL;
+}
+#endif
+
 uint8_t VS1000UART::volumeUp()
 {
-	volumeUpWithoutSaving();
-	saveVolumeToMemory();
+	// The volume is saved when the command completes.
+	runCommand(COMMANDVOLUMEUP);
 	return _volume;
 }
 
 uint8_t VS1000UART::volumeDown()
 {
-	volumeDownWithoutSaving();
-	saveVolumeToMemory();
+	runCommand(COMMANDVOLUMEDOWN);
 	return _volume;
 }
 
 uint8_t VS1000UART::setVolume(uint8_t volume)
 {
-	// If we need to turn volume down.
-	if (_volume > volume)
-	{
-		while (_volume > volume)
-		{
-			volumeDownWithoutSaving();
-		}
-	}
-
-	// If we need to turn volume up.
-	if (_volume < volume)
-	{
-		while (_volume < volume)
-		{
-			volumeUpWithoutSaving();
-		}
-	}
-
-	saveVolumeToMemory();
+	runCommand(COMMANDSETVOLUME, volume);
 	return _volume;
 }
 
@@ -329,30 +651,14 @@ VS1000UART::VOLUMELEVEL VS1000UART::setVolumeLevel(VOLUMELEVEL level)
 		level = _minimumLevel;
 	}
 
-
-	// Calculate new volume from level and size of increment per level.
-	uint8_t volume = round((level - _minimumLevel) * _volumeIncrement + _minimumVolume);
-
-	setVolume(volume);
+	setVolume(calculateVolumeFromLevel(level));
 
 	return level;
 }
 
 VS1000UART::VOLUMELEVEL VS1000UART::cycleVolumeLevel()
 {
-	VOLUMELEVEL level = getVolumeLevel();
-
-	if (level == _maximumLevel)
-	{
-		level = _minimumLevel;
-	}
-	else
-	{
-		level = (VOLUMELEVEL)(level + 1);
-	}
-	
-
-	return setVolumeLevel(level);
+	return setVolumeLevel(nextCycleLevel(getVolumeLevel()));
 }
 
 VS1000UART::VOLUMELEVEL VS1000UART::getVolumeLevel()
@@ -362,172 +668,2308 @@ VS1000UART::VOLUMELEVEL VS1000UART::getVolumeLevel()
 
 bool VS1000UART::pausePlay()
 {
-	sendCommand(F("=\n"));
-
-	return checkCommandResult('=');
+	return runCommand(COMMANDPAUSE);
 }
 
 bool VS1000UART::resumePlay()
 {
-	sendCommand(F(">\n"));
-
-	return checkCommandResult('>');
+	return runCommand(COMMANDRESUME);
 }
 
 bool VS1000UART::stopPlay()
 {
-	sendCommand(F("q\n"));
+	return runCommand(COMMANDSTOP);
+}
 
-	return checkCommandResult('q');
+bool VS1000UART::isPlaying()
+{
+	return _playing && !_paused;
 }
 
+#if VS1000PROGRESS
 bool VS1000UART::playTime(uint32_t* current, uint32_t* total)
 {
-	sendCommand(F("t"));
-
-	readLine();
-
-	if (strlen(_lineBuffer) != 12)
+	// Only ask the chip when the cached answer is too old or there is nothing to move along.  Paused, the cached answer stays exact.
+	if (!_playing || !_progressValid || (!_paused && millis() - _progressTime >= _progressRefresh))
 	{
-		// There seems to be a bug in the firmware.  If you call to playTime when a track is not playing, then call to list files the list files command fails.
-		// It's not known if the bug is from Adafruit or VSI.  This command is not in the VSI1000 data sheet, so it's either undocumented or added by Adafruit.
-		// As a work around, we can send a new line character and clear the buffer.
-		sendCommand(F("\n"));
-		readLine();
-		return false;
+		if (!runCommand(COMMANDPLAYTIME))
+		{
+			return false;
+		}
 	}
 
-	*current	= atoi(_lineBuffer);
-	*total		= atoi(_lineBuffer + 6);
+	// The chip answers in whole seconds and never past the end of the track.
+	*current	= interpolatedPosition() / 1000;
+	*total		= _totalTime;
+	if (*current > *total)
+	{
+		*current = *total;
+	}
 
 	return true;
 }
 
-bool VS1000UART::fileSize(uint32_t* remain, uint32_t* total)
+bool VS1000UART::fileSize(uint32_t* remaining, uint32_t* total)
 {
-	sendCommand(F("s"));
-
-	if (strlen(_lineBuffer) != 22)
+	if (!_playing || !_sizeValid || (!_paused && millis() - _sizeTime >= _progressRefresh))
 	{
-		return false;
+		if (!runCommand(COMMANDFILESIZE))
+		{
+			return false;
+		}
 	}
 
-	*remain	= atol(_lineBuffer);
-	*total	= atol(_lineBuffer + 11);
+	*remaining	= interpolatedRemainingBytes();
+	*total		= _totalBytes;
 
 	return true;
 }
+#endif
 
-void VS1000UART::continuousPlayMode()
+void VS1000UART::setPlaylist(const uint8_t* fileNumbers, uint8_t count)
 {
-
+	_playlist		= fileNumbers;
+	_playlistLength	= count;
+	_playlistActive	= false;
 }
 
-void VS1000UART::sendCommand(const __FlashStringHelper* command)
+void VS1000UART::setTrackCallback(TrackCallback callback)
 {
-	while (_chipStream->available())
-	{
-		_chipStream->read();
-	}
-
-	_chipStream->print(command);
+	_trackCallback = callback;
 }
 
-bool VS1000UART::checkCommandResult(char command)
+bool VS1000UART::continuousPlayMode(PLAYLISTMODE mode)
 {
-	// Read the response with "readLine" which returns the number of bytes read.  No bytes are read, then return false.
-	// This uses short-circuit logic, if the first part true, the second part doesn't execute, it goes straight to the return.
-	if (!readLine() || _lineBuffer[0] != command)
+	if (_playlist == NULL || _playlistLength == 0)
 	{
 		return false;
 	}
-	
+
+	_playlistMode		= mode;
+	_playlistPosition	= _playlistNotStarted;
+	_playlistActive		= true;
+	_playlistNext		= true;
+	_playlistAdvancing	= false;
 	return true;
 }
 
-VS1000UART::VOLUMELEVEL VS1000UART::calculateLevelFromVolume(uint8_t volume)
+bool VS1000UART::isContinuousPlay()
 {
-	return (VOLUMELEVEL)(round((volume - _minimumVolume) / _volumeIncrement + _minimumLevel));
+	return _playlistActive;
 }
 
-void VS1000UART::synchVolumes()
+void VS1000UART::holdReset()
 {
-	// We need to initialize the "_volume" variable before a call to "setVolume."  To do that, we will make a call to volume up
-	// and that will set the variable as part of the call.  Do not save the volume or we overwrite the value we are trying to restore.
-	volumeUpWithoutSaving();
+	waitForIdle();
 
-	if (_persistentVolume)
-	{
-		// Read the volume from memory.  Then calculate and set a new volume level.
-		uint8_t volume = EEPROM.readInt(_memoryAddress);
-		setVolumeLevel(calculateLevelFromVolume(volume));
-	}
+	// Held low the same way as a reset.  The reset started by "releaseReset" lets it go.
+	pinMode(_resetPin, OUTPUT);
+	digitalWrite(_resetPin, LOW);
+	_heldInReset		= true;
+	_heldVolume			= _volume;
+	_playing			= false;
+	_paused				= false;
+	_playlistActive		= false;
+	_playlistAdvancing	= false;
+	#if VS1000LISTING
+	_fileTableKept		= _fileTableReady;
+	_fileTableReady		= false;
+	#endif
+	#if VS1000PROGRESS
+	_progressValid		= false;
+	_sizeValid			= false;
+	#endif
 }
 
-int VS1000UART::readLine()
+bool VS1000UART::releaseReset()
 {
-	int x 			= _chipStream->readBytesUntil('\n', _lineBuffer, _lineBufferSize);
-	_lineBuffer[x]	= 0;
+	if (!_heldInReset)
+	{
+		return false;
+	}
+
+	_heldInReset = false;
+	if (!reset())
+	{
+		return false;
+	}
 
-	// Check for when the new line is followed by a carriage return.
-	if (_chipStream->peek() == '\r')
+	// The chip boots at full volume.  A saved volume has already been restored by the reset.
+	if (_volume != _heldVolume)
 	{
-		_chipStream->read();
+		runCommand(COMMANDSETVOLUME, _heldVolume);
 	}
 
-	#if VS1000DEBUGLEVEL > 1
-		Serial.print(F("Line buffer\tbits: "));
-		Serial.print(x);
-		Serial.print(F("\tvalue: "));
-		Serial.println(_lineBuffer);
+	return true;
+}
+
+bool VS1000UART::isHeldInReset()
+{
+	return _heldInReset;
+}
+
+bool VS1000UART::isChipDown()
+{
+	return _chipDown;
+}
+
+void VS1000UART::sleep()
+{
+	#if defined(__AVR__)
+		set_sleep_mode(SLEEP_MODE_IDLE);
+		sleep_mode();
+	#elif defined(ARDUINO_ARCH_ESP32)
+		delay(1);
+	#elif defined(__arm__)
+		__WFI();
+	#else
+		yield();
 	#endif
+}
+
+#if VS1000PERSISTENCE
+void VS1000UART::useStateSnapshot(int memoryAddress, uint8_t slots)
+{
+	_stateAddress	= _storage ? memoryAddress : -1;
+	_stateSlots		= slots > 0 ? slots : 1;
 
-	// The number of characters placed in the buffer (0 means no valid data found).
-	return x;
+	// Until a snapshot is found, the first save goes to slot 0.
+	_stateSlot		= _stateSlots - 1;
 }
 
-void VS1000UART::volumeUpWithoutSaving()
+bool VS1000UART::restoreState()
 {
-	while (_chipStream->available())
+	// From here on changes are saved.
+	_stateRestored = true;
+
+	if (_stateAddress < 0)
 	{
-		_chipStream->read();
+		return false;
 	}
 
-	// Send the volume change command to the chip.
-	_chipStream->println(F("+"));
+	// The newest slot that checks out.  Erased memory, a write cut short, or a snapshot of another layout fail the check, so a save that
+	// was cut short leaves the one before it.  Sequence numbers wrap, newer is less than half the range ahead.
+	StateSnapshot	snapshot;
+	int16_t			newest = -1;
+	for (uint8_t i = 0; i < _stateSlots; i++)
+	{
+		_storage->readBlock(_stateAddress + i * sizeof(StateSnapshot), &snapshot, sizeof(snapshot));
+		if (snapshot.version != _stateVersion || snapshot.check != stateChecksum((const uint8_t*)&snapshot, sizeof(snapshot) - 2))
+		{
+			continue;
+		}
 
-	// Reads the returned value from the chip and saves it.
-	readVolumeFromChip();
-}
+		if (newest < 0 || (int16_t)(snapshot.sequence - _stateSequence) > 0)
+		{
+			newest			= i;
+			_stateSequence	= snapshot.sequence;
+		}
+	}
 
-void VS1000UART::volumeDownWithoutSaving()
-{
-	while (_chipStream->available())
+	if (newest < 0)
 	{
-		_chipStream->read();
+		return false;
 	}
+	_stateSlot = newest;
+	_storage->readBlock(_stateAddress + newest * sizeof(StateSnapshot), &snapshot, sizeof(snapshot));
 
-	// Send the volume change command to the chip.
-	_chipStream->println(F("-"));
+	if (snapshot.volume > _chipMaxVolume || snapshot.minimumVolume > snapshot.maximumVolume || snapshot.minimumLevel > snapshot.maximumLevel ||
+		snapshot.maximumLevel > VOLUME10 || snapshot.playlistMode > PLAYLISTSHUFFLE)
+	{
+		return false;
+	}
 
-	// Reads the returned value from the chip and saves it.
-	readVolumeFromChip();
-}
+	_minimumVolume	= snapshot.minimumVolume;
+	_maximumVolume	= snapshot.maximumVolume;
+	_minimumLevel	= (VOLUMELEVEL)snapshot.minimumLevel;
+	_maximumLevel	= (VOLUMELEVEL)snapshot.maximumLevel;
+	_lastTrack		= snapshot.track;
+	buildLevelTable();
 
-void VS1000UART::readVolumeFromChip()
-{
-	// Read the serial stream from the chip.
-	readLine();
+	if (snapshot.volume != queuedVolume())
+	{
+		queueCommand(COMMANDSETVOLUME, snapshot.volume);
+	}
 
-	// Convert the text to a numerical volume.
-	_volume = atoi(_lineBuffer);
-}
+	// A track number only means the same track if the chip still has the same files.
+	bool sameFiles = _bootFileCount < 0 || snapshot.fileCount == (uint8_t)_bootFileCount;
+	#if VS1000LISTING
+	sameFiles = sameFiles && (!_fileTableReady || snapshot.fileTableChecksum == 0 || snapshot.fileTableChecksum == fileTableChecksum());
+	#endif
 
-void VS1000UART::saveVolumeToMemory()
-{
-	// When we have volume saving enabled, we save it to the flash memory on the Arduino.
-	if (_persistentVolume)
+	bool samePlaylist = _playlist != NULL && snapshot.playlistLength == _playlistLength && snapshot.playlistPosition < _playlistLength &&
+		snapshot.playlistChecksum == stateChecksum(_playlist, _playlistLength);
+
+	bool playing = false;
+	if (sameFiles && (snapshot.flags & _statePlaylist) && samePlaylist)
 	{
-		EEPROM.writeInt(_memoryAddress, _volume);
+		// Started the same way "updatePlaylist" starts a track, so continuous play goes on from it.
+		_playlistMode		= (PLAYLISTMODE)snapshot.playlistMode;
+		_playlistPosition	= snapshot.playlistPosition;
+		_playlistActive		= true;
+		_playlistNext		= false;
+		_playlistAdvancing	= true;
+		playing				= queueCommand(COMMANDPLAYNUMBER, _playlist[_playlistPosition]);
 	}
-}
\ No newline at end of file
+	else if (sameFiles && (snapshot.flags & _statePlaying))
+	{
+		playing = queueCommand(COMMANDPLAYNUMBER, snapshot.track);
+	}
+
+	if (playing && (snapshot.flags & _statePaused))
+	{
+		queueCommand(COMMANDPAUSE);
+	}
+
+	waitForIdle();
+	return true;
+}
+#endif
+
+bool VS1000UART::queueCommand(COMMAND command, uint8_t argument)
+{
+	// A chip that is down only takes the reset that brings it back.
+	if (command == COMMANDNONE || _heldInReset || (_chipDown && command != COMMANDRESET))
+	{
+		return false;
+	}
+
+	// Commands of features that aren't built in, see "VS1000Config.h."
+	#if !VS1000PLAYBYNAME
+	if (command == COMMANDPLAYNAME)
+	{
+		return false;
+	}
+	#endif
+	#if !VS1000LISTING
+	if (command == COMMANDLISTFILES)
+	{
+		return false;
+	}
+	#endif
+	#if !VS1000PROGRESS
+	if (command == COMMANDFILESIZE)
+	{
+		return false;
+	}
+	#endif
+
+	int8_t index;
+	switch (command)
+	{
+		case COMMANDPLAYNUMBER:
+		case COMMANDPLAYNAME:
+			// A newer play replaces one that hasn't been sent.  If that was the next track of the playlist, the playlist is over.  If it
+			// was looked up by name, this one isn't, unless "queuePlayFile" says so.
+			#if VS1000PLAYBYNAME && VS1000LISTING
+			_playLookedUp = false;
+			#endif
+			index = findQueuedCommand(COMMANDPLAYNUMBER, COMMANDPLAYNAME);
+			if (index >= 0)
+			{
+				if (_playlistAdvancing)
+				{
+					_playlistAdvancing	= false;
+					_playlistActive		= false;
+				}
+
+				queuedCommandAt(index).command	= command;
+				queuedCommandAt(index).argument	= argument;
+				return true;
+			}
+			break;
+
+		case COMMANDVOLUMEUP:
+		case COMMANDVOLUMEDOWN:
+		case COMMANDSETVOLUME:
+		{
+			// Steps used to synchronize the volume are not saved, so they are kept as they are.
+			if (command != COMMANDSETVOLUME && argument == _volumeNotSaved)
+			{
+				break;
+			}
+
+			// Find the last volume change and, if it is one that gets saved, turn the two into a single target volume.
+			for (index = _commandQueueCount - 1; index >= 0; index--)
+			{
+				COMMAND queuedCommand = queuedCommandAt(index).command;
+				if (queuedCommand == COMMANDVOLUMEUP || queuedCommand == COMMANDVOLUMEDOWN || queuedCommand == COMMANDSETVOLUME)
+				{
+					break;
+				}
+			}
+
+			if (index >= 0 && (queuedCommandAt(index).command == COMMANDSETVOLUME || queuedCommandAt(index).argument != _volumeNotSaved))
+			{
+				uint8_t target					= volumeAfterCommand(queuedVolume(), command, argument);
+				queuedCommandAt(index).command	= COMMANDSETVOLUME;
+				queuedCommandAt(index).argument	= target;
+				return true;
+			}
+			break;
+		}
+
+		case COMMANDPAUSE:
+		case COMMANDRESUME:
+		case COMMANDSTOP:
+		case COMMANDPLAYTIME:
+		case COMMANDFILESIZE:
+			// Asking twice gets the same answer.
+			if (findQueuedCommand(command) >= 0)
+			{
+				return true;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	if (_commandQueueCount == VS1000COMMANDQUEUESIZE)
+	{
+		return false;
+	}
+
+	// Transport commands go ahead of status requests, everything else goes on the end.
+	index = _commandQueueCount;
+	if (command == COMMANDPAUSE || command == COMMANDRESUME || command == COMMANDSTOP)
+	{
+		int8_t statusIndex = findQueuedCommand(COMMANDPLAYTIME, COMMANDFILESIZE);
+		if (statusIndex >= 0)
+		{
+			index = statusIndex;
+		}
+	}
+
+	// Make room in the ring buffer by moving the later commands back one.
+	for (uint8_t i = _commandQueueCount; i > index; i--)
+	{
+		queuedCommandAt(i) = queuedCommandAt(i - 1);
+	}
+	queuedCommandAt(index).command	= command;
+	queuedCommandAt(index).argument	= argument;
+	_commandQueueCount++;
+
+	return true;
+}
+
+#if VS1000PLAYBYNAME
+bool VS1000UART::queuePlayFile(const char* fileName)
+{
+	// There is only one buffer for the name.  That is enough because a newer play replaces a queued one, and the name of the active
+	// one has already been sent.  An active play that was looked up isn't checked against its name any more, this one replaces it.
+	#if VS1000LISTING
+	_checkPlayName = false;
+	#endif
+	strncpy(_queuedFileName, fileName, 11);
+	_queuedFileName[11] = 0;
+
+	// Playing by number saves sending most of the name.  The name is kept to check the answer, see "checkPlayedName."
+	#if VS1000LISTING
+	int16_t fileNumber = findFile(fileName);
+	if (fileNumber >= 0)
+	{
+		if (!queueCommand(COMMANDPLAYNUMBER, fileNumber))
+		{
+			return false;
+		}
+		_playLookedUp = true;
+		return true;
+	}
+	#endif
+
+	return queueCommand(COMMANDPLAYNAME);
+}
+#endif
+
+bool VS1000UART::queueVolumeLevel(VOLUMELEVEL level)
+{
+	// "calculateVolumeFromLevel" keeps the level between the minimum and the maximum.
+	return queueCommand(COMMANDSETVOLUME, calculateVolumeFromLevel(level));
+}
+
+bool VS1000UART::queueVolumeLevelStep(int8_t steps)
+{
+	int8_t level = getQueuedVolumeLevel() + steps;
+	if (level < _minimumLevel)
+	{
+		level = _minimumLevel;
+	}
+	if (level > _maximumLevel)
+	{
+		level = _maximumLevel;
+	}
+
+	return queueVolumeLevel((VOLUMELEVEL)level);
+}
+
+bool VS1000UART::queueCycleVolumeLevel()
+{
+	return queueVolumeLevel(nextCycleLevel(getQueuedVolumeLevel()));
+}
+
+VS1000UART::VOLUMELEVEL VS1000UART::getQueuedVolumeLevel()
+{
+	return calculateLevelFromVolume(queuedVolume());
+}
+
+#if VS1000LISTING
+bool VS1000UART::queueListFiles(FileCallback callback)
+{
+	// There is only one set of listing destinations.
+	if (_fileCallback || _listFileNames)
+	{
+		return false;
+	}
+
+	if (!queueCommand(COMMANDLISTFILES))
+	{
+		return false;
+	}
+
+	// Cleared now rather than when the listing starts, "listFiles" would otherwise see the last listing's stop and return early.
+	_fileCallback			= callback;
+	_fileCallbackStopped	= false;
+	return true;
+}
+#endif
+
+bool VS1000UART::isPlayArmed()
+{
+	return _playArmed && _transport->transmitSpace() == VS1000TRANSMITBUFFERSIZE;
+}
+
+bool VS1000UART::triggerArmedPlay()
+{
+	if (!_playArmed)
+	{
+		return false;
+	}
+
+	// A bare new line is enough to end a command, the same as pausing, and is the shortest trigger.
+	sendText(F("\n"));
+	_transport->update();
+	_playArmed			= false;
+	_commandStartTime	= millis();
+	return true;
+}
+
+void VS1000UART::poll()
+{
+	updateActivity();
+	updatePlaylist();
+
+	if (_watchdogTimeouts > 0)
+	{
+		updateWatchdog();
+	}
+
+	#if VS1000PERSISTENCE
+	if (_volumeDirty && millis() - _volumeChangeTime >= _volumeSaveDelay)
+	{
+		commitVolumeToMemory();
+	}
+
+	if (_stateDirty && millis() - _stateChangeTime >= (_volumeSaveDelay > _minimumStateSaveDelay ? _volumeSaveDelay : _minimumStateSaveDelay))
+	{
+		commitState();
+	}
+	#endif
+
+	// Ask for the length of a track that isn't known yet.  Only while idle, so it doesn't take the status a blocking call waits for.
+	#if VS1000LISTING
+	if (_trackLengthWanted && isIdle())
+	{
+		_trackLengthWanted = false;
+		queueCommand(COMMANDPLAYTIME);
+	}
+	#endif
+
+	if (_activeCommand == COMMANDNONE)
+	{
+		startNextCommand();
+	}
+
+	// Parse the response one byte at a time, only taking what has already arrived.  The command can complete part way through, then
+	// the bytes after it are left for the next command.
+	if (_activeCommand == COMMANDSETVOLUME)
+	{
+		sendVolumeSteps();
+	}
+
+	if (_resetHolding)
+	{
+		if (millis() - _commandStartTime < _resetHoldTime)
+		{
+			return;
+		}
+
+		// Swith the pin back to input.  The reset pin is connected to Vcc.  By switching to input, we will let the
+		// reset be pulled back to Vcc.  The chip may not run at the same voltage as the Arduino so we don't control it
+		// with the Arduino.  The boot time is measured from here.
+		pinMode(_resetPin, INPUT);
+		_resetHolding		= false;
+		_commandStartTime	= millis();
+
+		// Anything that arrived while the reset pin was held is a left over from before the reset.
+		_transport->discardReceived();
+	}
+
+	_transport->update();
+
+	// Everything received is read, whether a command is waiting or not.  The answer to a command can't come before it is sent, so
+	// a line that ends while no command is active doesn't answer anything.
+	int character;
+	while ((character = _transport->read()) >= 0)
+	{
+		// Anything received shows the chip is running.
+		_receiveTime			= millis();
+		_consecutiveTimeouts	= 0;
+		if (!readLineByte(character))
+		{
+			continue;
+		}
+
+		if (_activeCommand == COMMANDNONE || (_activeCommand != COMMANDRESET && _tokenizer.found(VS1000Tokenizer::KEYWORDBANNER)))
+		{
+			processUnsolicitedLine(_tokenizer.length());
+		}
+		else
+		{
+			processResponseLine(_tokenizer.length());
+		}
+	}
+
+	if (_activeCommand == COMMANDRESET)
+	{
+		if (millis() - _commandStartTime > _resetTimeout)
+		{
+			// At the wrong rate the boot messages read as garbage, which can still contain line ends, so when probing only the
+			// banner or the number of files count.
+			bool recognized = _bootBannerFound || _bootFileCount >= 0;
+			if (_baudProbing && _probeStartRate != 0 && !recognized)
+			{
+				if (probeNextBaudRate())
+				{
+					return;
+				}
+				_bootLineCount = 0;
+			}
+
+			// Other boards with the VS1000 may print something else or less, so any boot message means the chip is running.
+			_bootTime = millis() - _commandStartTime;
+			completeCommand(_bootLineCount > 0 ? STATUSSUCCESS : STATUSTIMEDOUT);
+		}
+	}
+	else if (_playArmed)
+	{
+		// There is no time out while waiting to be triggered.
+		_commandStartTime = millis();
+	}
+	else if (_activeCommand != COMMANDNONE && millis() - _commandStartTime > getTimeout(timeoutClassOf(_activeCommand)))
+	{
+		if (_activeCommand == COMMANDLISTFILES)
+		{
+			// The listing has no end marker, it is over when the chip stops sending.
+			completeCommand(STATUSSUCCESS);
+		}
+		else if (_activeCommand == COMMANDPLAYTIME && !_workaroundSent)
+		{
+			// No answer to the play time is handled like a bad answer.
+			sendPlayTimeWorkaround();
+		}
+		else
+		{
+			// The chip did change for each volume echoed back before the time out, so keep that much.
+			if (_activeCommand == COMMANDSETVOLUME)
+			{
+				_volume = _pipelineVolume;
+			}
+
+			// The measured times were too short for the chip now, start over from the set time out.
+			TIMEOUTCLASS timeoutClass			= timeoutClassOf(_activeCommand);
+			_averageResponse[timeoutClass]		= 0;
+			_responseDeviation[timeoutClass]	= 0;
+
+			// The answer may still come.  The next command waits a moment so it isn't taken as the answer to that one.  The play
+			// time work around is only answered by a blank line, if at all.
+			if (!_workaroundSent)
+			{
+				_lateCommand	= _activeCommand;
+				_lateTime		= millis();
+			}
+
+			// The play time work around finishes by timing out because it isn't known if the chip answers the extra new line.
+			completeCommand(_workaroundSent ? STATUSFAILED : STATUSTIMEDOUT);
+		}
+	}
+}
+
+bool VS1000UART::isIdle()
+{
+	return _activeCommand == COMMANDNONE && _commandQueueCount == 0;
+}
+
+VS1000UART::COMMANDSTATUS VS1000UART::getCommandStatus()
+{
+	return _commandStatus;
+}
+
+void VS1000UART::setCommandCallback(CommandCallback callback)
+{
+	_commandCallback = callback;
+}
+
+void VS1000UART::setEventCallback(EventCallback callback)
+{
+	_eventCallback = callback;
+}
+
+uint16_t VS1000UART::getUnsolicitedCount()
+{
+	return _unsolicitedCount;
+}
+
+void VS1000UART::getLastPlayTime(uint32_t* current, uint32_t* total)
+{
+	*current	= _currentTime;
+	*total		= _totalTime;
+}
+
+#if VS1000PROGRESS
+void VS1000UART::getLastFileSize(uint32_t* remaining, uint32_t* total)
+{
+	*remaining	= _remainingBytes;
+	*total		= _totalBytes;
+}
+#endif
+
+VS1000UART::QueuedCommand& VS1000UART::queuedCommandAt(uint8_t index)
+{
+	return _commandQueue[(_commandQueueStart + index) % VS1000COMMANDQUEUESIZE];
+}
+
+int8_t VS1000UART::findQueuedCommand(COMMAND command, COMMAND otherCommand)
+{
+	for (uint8_t i = 0; i < _commandQueueCount; i++)
+	{
+		COMMAND queuedCommand = queuedCommandAt(i).command;
+		if (queuedCommand == command || (otherCommand != COMMANDNONE && queuedCommand == otherCommand))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+uint8_t VS1000UART::queuedVolume()
+{
+	uint8_t volume = volumeAfterCommand(_volume, _activeCommand, _activeArgument);
+	for (uint8_t i = 0; i < _commandQueueCount; i++)
+	{
+		volume = volumeAfterCommand(volume, queuedCommandAt(i).command, queuedCommandAt(i).argument);
+	}
+
+	return volume;
+}
+
+uint8_t VS1000UART::volumeAfterCommand(uint8_t volume, COMMAND command, uint8_t argument)
+{
+	switch (command)
+	{
+		case COMMANDVOLUMEUP:
+			return volume > _chipMaxVolume - _chipVolumeStep ? _chipMaxVolume : volume + _chipVolumeStep;
+
+		case COMMANDVOLUMEDOWN:
+			return volume < _chipMinVolume + _chipVolumeStep ? _chipMinVolume : volume - _chipVolumeStep;
+
+		case COMMANDSETVOLUME:
+			return argument > _chipMaxVolume ? _chipMaxVolume : argument;
+
+		default:
+			return volume;
+	}
+}
+
+bool VS1000UART::runCommand(COMMAND command, uint8_t argument)
+{
+	// Fails right away while the chip is down, instead of waiting for the reset going on in the background.
+	if (_chipDown && command != COMMANDRESET)
+	{
+		return false;
+	}
+
+	// Wait for any commands queued ahead of us so there is room in the queue and the status we read at the end is ours.
+	waitForIdle();
+
+	if (!queueCommand(command, argument))
+	{
+		return false;
+	}
+
+	waitForIdle();
+	return _commandStatus == STATUSSUCCESS;
+}
+
+void VS1000UART::waitForIdle()
+{
+	while (!isIdle())
+	{
+		poll();
+
+		if (_powerSaving && !isIdle())
+		{
+			sleep();
+		}
+	}
+}
+
+void VS1000UART::markChipDown()
+{
+	// Kept the same way as holding the chip in reset, so the recovery can put them back.
+	_chipDown			= true;
+	_heldVolume			= _volume;
+	_playing			= false;
+	_paused				= false;
+	dropQueuedCommands();
+	#if VS1000LISTING
+	_fileTableKept		= _fileTableReady;
+	_fileTableReady		= false;
+	#endif
+	#if VS1000PROGRESS
+	_progressValid		= false;
+	_sizeValid			= false;
+	#endif
+
+	// The first reset is started by the next "poll."
+	_recoveryTime = millis() - _recoveryInterval;
+
+	if (_eventCallback)
+	{
+		_eventCallback(EVENTCHIPDOWN, "");
+	}
+}
+
+void VS1000UART::dropQueuedCommands()
+{
+	_commandQueueCount = 0;
+	#if VS1000PLAYBYNAME && VS1000LISTING
+	_playLookedUp = false;
+	#endif
+
+	// A listing that won't be sent gives up its destinations, or every later listing would be refused and the next one would fill
+	// them in.
+	#if VS1000LISTING
+	_fileCallback	= NULL;
+	_listFileNames	= NULL;
+	_listFileSizes	= NULL;
+	#endif
+
+	// Nor will the next track of the playlist, so it is over, the same as when another track is played.
+	if (_playlistAdvancing)
+	{
+		_playlistAdvancing	= false;
+		_playlistActive		= false;
+	}
+}
+
+void VS1000UART::updateWatchdog()
+{
+	if (_chipDown && isIdle() && millis() - _recoveryTime >= _recoveryInterval)
+	{
+		_recoveryTime = millis();
+		queueCommand(COMMANDRESET);
+	}
+
+	// Back once the volume and file table queued after the reset are done.
+	if (_recovering && isIdle())
+	{
+		_recovering = false;
+
+		if (_eventCallback)
+		{
+			_eventCallback(EVENTRECOVERED, "");
+		}
+	}
+}
+
+void VS1000UART::startNextCommand()
+{
+	// Wait until the last command has been handed to the hardware so the whole of this one fits in the transmit buffer.
+	if (_commandQueueCount == 0 || _transport->transmitSpace() < VS1000TRANSMITBUFFERSIZE)
+	{
+		return;
+	}
+
+	// Give the answer to a command that timed out a moment to come in, and let a line that is coming in finish, so neither is taken
+	// as the answer to this command.  A part of a line older than that is thrown away when the command starts.
+	if (_lateCommand != COMMANDNONE)
+	{
+		if (millis() - _lateTime < _lateAnswerTime)
+		{
+			return;
+		}
+		_lateCommand = COMMANDNONE;
+	}
+
+	if (_tokenizer.inLine() && millis() - _receiveTime < _lateAnswerTime)
+	{
+		return;
+	}
+
+	// Take the command off the front of the ring buffer.
+	QueuedCommand& queuedCommand	= _commandQueue[_commandQueueStart];
+	_activeCommand					= queuedCommand.command;
+	_activeArgument					= queuedCommand.argument;
+	_commandQueueStart				= (_commandQueueStart + 1) % VS1000COMMANDQUEUESIZE;
+	_commandQueueCount--;
+
+	// Lines that came in since the last command didn't answer anything, they are counted for this one.
+	#if VS1000STATISTICS
+	if (_statistics)
+	{
+		_statistics->recordDrained(_activeCommand, _unsolicitedBytes);
+		_commandStartMicros = micros();
+	}
+	#endif
+	_unsolicitedBytes = 0;
+
+	// Every command ends with a bare new line, the firmware drops carriage returns.  The play time and file size are the exception,
+	// they are sent on their own, see "sendPlayTimeWorkaround."
+	char number[4];
+	switch (_activeCommand)
+	{
+		case COMMANDPLAYNUMBER:
+			#if VS1000PLAYBYNAME && VS1000LISTING
+			_checkPlayName	= _playLookedUp;
+			_playLookedUp	= false;
+			#endif
+			utoa(_activeArgument, number, 10);
+			sendFrame('#', number, true);
+			break;
+
+		case COMMANDPLAYARMED:
+			// The chip doesn't act on the line until the end of it is sent by "triggerArmedPlay."
+			utoa(_activeArgument, number, 10);
+			sendFrame('#', number, false);
+			_playArmed = true;
+			break;
+
+		#if VS1000PLAYBYNAME
+		case COMMANDPLAYNAME:
+			sendFrame('P', _queuedFileName, true);
+			break;
+		#endif
+
+		case COMMANDVOLUMEUP:
+			sendText(F("+\n"));
+			break;
+
+		case COMMANDVOLUMEDOWN:
+			sendText(F("-\n"));
+			break;
+
+		case COMMANDPAUSE:
+			sendText(F("=\n"));
+			break;
+
+		case COMMANDRESUME:
+			sendText(F(">\n"));
+			break;
+
+		case COMMANDSTOP:
+			sendText(F("q\n"));
+			break;
+
+		case COMMANDPLAYTIME:
+			// Asking when nothing is playing costs a time out and triggers the firmware bug, so don't if the activity pin says so.
+			if (_activityPin >= 0 && !_playing)
+			{
+				completeCommand(STATUSFAILED);
+				return;
+			}
+			sendText(F("t"));
+			break;
+
+		#if VS1000PROGRESS
+		case COMMANDFILESIZE:
+			if (_activityPin >= 0 && !_playing)
+			{
+				completeCommand(STATUSFAILED);
+				return;
+			}
+			sendText(F("s"));
+			break;
+		#endif
+
+		#if VS1000LISTING
+		case COMMANDLISTFILES:
+			sendText(F("L\n"));
+			_listedFileCount		= 0;
+			_fileCallbackStopped	= false;
+			break;
+		#endif
+
+		case COMMANDRESET:
+			// A connection that doesn't know its rate can't be moved to another one.
+			_baudAttempt	= 0;
+			_probeStartRate	= _transport->getBaudRate();
+			startReset();
+			break;
+
+		case COMMANDSETVOLUME:
+			// Steps are sent from "sendVolumeSteps."  Work out how many are needed from where we are now.
+			if (_activeArgument > _chipMaxVolume)
+			{
+				_activeArgument = _chipMaxVolume;
+			}
+			_pipelineVolume			= _volume;
+			_pipelineStartVolume	= _volume;
+			_volumeStepsInFlight	= 0;
+			_volumeStepsToSend		= (abs(_activeArgument - _volume) + _chipVolumeStep - 1) / _chipVolumeStep;
+			break;
+
+		default:
+			break;
+	}
+
+	_commandStatus		= STATUSPENDING;
+	_commandStartTime	= millis();
+	_workaroundSent		= false;
+	_tokenizer.reset();
+
+	// Already at the requested volume, or no files to list, nothing to wait for.
+	if (_activeCommand == COMMANDSETVOLUME && _volumeStepsToSend == 0)
+	{
+		completeCommand(STATUSSUCCESS);
+	}
+	#if VS1000LISTING
+	else if (_activeCommand == COMMANDLISTFILES && _bootFileCount == 0)
+	{
+		completeCommand(STATUSSUCCESS);
+	}
+	#endif
+}
+
+void VS1000UART::processUnsolicitedLine(uint8_t lineLength)
+{
+	// Blank lines are part of how the chip ends its answers.
+	if (lineLength == 0)
+	{
+		return;
+	}
+
+	_unsolicitedBytes = lineLength > 255 - _unsolicitedBytes ? 255 : _unsolicitedBytes + lineLength;
+
+	EVENT event = EVENTUNKNOWNLINE;
+	if (_tokenizer.found(VS1000Tokenizer::KEYWORDBANNER))
+	{
+		event = EVENTREBOOT;
+	}
+	else if (_lateCommand != COMMANDNONE)
+	{
+		event = EVENTLATEANSWER;
+
+		// Each step of a volume change is echoed, so keep waiting for the rest.  Anything else answers once.
+		if (timeoutClassOf(_lateCommand) == TIMEOUTVOLUME)
+		{
+			readVolumeFromChip();
+		}
+		else
+		{
+			_lateCommand = COMMANDNONE;
+		}
+	}
+	else if (_unsolicitedCount < 65535)
+	{
+		_unsolicitedCount++;
+	}
+
+	if (_eventCallback)
+	{
+		_eventCallback(event, _lineBuffer);
+	}
+
+	if (event != EVENTREBOOT)
+	{
+		return;
+	}
+
+	// The chip restarted on its own.  Whatever was waiting for an answer won't get one.  The rest of the boot is handled as if a
+	// reset had been sent, which also puts the volume and file table back.
+	if (_activeCommand != COMMANDNONE)
+	{
+		completeCommand(STATUSFAILED);
+	}
+
+	_activeCommand		= COMMANDRESET;
+	_commandStatus		= STATUSPENDING;
+	_commandStartTime	= millis();
+	_lateCommand		= COMMANDNONE;
+	_bootBannerFound	= true;
+	_bootLineCount		= 1;
+	_bootFileCount		= -1;
+	#if VS1000LISTING
+	_fileTableReady		= false;
+	#endif
+
+	#if VS1000STATISTICS
+	_commandStartMicros = micros();
+	#endif
+}
+
+void VS1000UART::processResponseLine(uint8_t lineLength)
+{
+	// Only the play time and size use empty lines, they need to know when the chip sent a blank answer.
+	if (lineLength == 0 && _activeCommand != COMMANDPLAYTIME && _activeCommand != COMMANDFILESIZE)
+	{
+		return;
+	}
+
+	switch (_activeCommand)
+	{
+		case COMMANDPLAYNUMBER:
+		case COMMANDPLAYNAME:
+		case COMMANDPLAYARMED:
+		{
+			// Skip anything until we get "play" back.  The number after it is the track that started.
+			if (!_tokenizer.found(VS1000Tokenizer::KEYWORDPLAY))
+			{
+				if (_tokenizer.found(VS1000Tokenizer::KEYWORDNOFILE))
+				{
+					completeCommand(STATUSFAILED);
+				}
+				break;
+			}
+
+			if (_activeCommand != COMMANDPLAYNAME && _tokenizer.firstNumber() != _activeArgument)
+			{
+				completeCommand(STATUSFAILED);
+				break;
+			}
+
+			#if VS1000PLAYBYNAME && VS1000LISTING
+			if (_activeCommand == COMMANDPLAYNUMBER && _checkPlayName && !checkPlayedName())
+			{
+				break;
+			}
+			#endif
+
+			_lastTrack = _tokenizer.firstNumber();
+			completeCommand(STATUSSUCCESS);
+			break;
+		}
+
+		case COMMANDVOLUMEUP:
+		case COMMANDVOLUMEDOWN:
+		{
+			completeCommand(readVolumeFromChip() ? STATUSSUCCESS : STATUSFAILED);
+			break;
+		}
+
+		case COMMANDPAUSE:
+		case COMMANDRESUME:
+		case COMMANDSTOP:
+		{
+			// The chip echoes the command character back.
+			const char echo = _activeCommand == COMMANDPAUSE ? '=' : (_activeCommand == COMMANDRESUME ? '>' : 'q');
+			completeCommand(_lineBuffer[0] == echo ? STATUSSUCCESS : STATUSFAILED);
+			break;
+		}
+
+		case COMMANDSETVOLUME:
+		{
+			processVolumeStep();
+			break;
+		}
+
+		case COMMANDRESET:
+		{
+			processBootLine();
+			break;
+		}
+
+		#if VS1000LISTING
+		case COMMANDLISTFILES:
+		{
+			processListLine(lineLength);
+			break;
+		}
+		#endif
+
+		case COMMANDPLAYTIME:
+		{
+			if (_workaroundSent)
+			{
+				completeCommand(STATUSFAILED);
+				break;
+			}
+
+			// Format is "ccccc:ttttt".
+			if (lineLength != 11 || _tokenizer.numberCount() != 2)
+			{
+				sendPlayTimeWorkaround();
+				break;
+			}
+
+			_currentTime	= _tokenizer.firstNumber();
+			_totalTime		= _tokenizer.lastNumber();
+			completeCommand(STATUSSUCCESS);
+			break;
+		}
+
+		#if VS1000PROGRESS
+		case COMMANDFILESIZE:
+		{
+			// Format is "rrrrrrrrrr:tttttttttt", the bytes remaining then the total.  Anything else, including a blank line, means
+			// nothing is playing.
+			if (_tokenizer.numberCount() != 2)
+			{
+				completeCommand(STATUSFAILED);
+				break;
+			}
+
+			// The byte rate is measured from how far the track moved since the last answer.
+			uint32_t		remainingBytes	= _tokenizer.firstNumber();
+			unsigned long	elapsed			= millis() - _sizeTime;
+			if (_sizeValid && remainingBytes < _remainingBytes && elapsed > 0)
+			{
+				uint32_t played	= _remainingBytes - remainingBytes;
+				_byteRate		= played / elapsed * 1000 + played % elapsed * 1000 / elapsed;
+			}
+
+			_remainingBytes	= remainingBytes;
+			_totalBytes		= _tokenizer.lastNumber();
+			completeCommand(STATUSSUCCESS);
+			break;
+		}
+		#endif
+
+		default:
+			break;
+	}
+}
+
+void VS1000UART::sendVolumeSteps()
+{
+	// Stream the steps back to back instead of waiting for each echo.  The window limits how many echoes can pile up in the receive
+	// buffer of the stream (a SoftwareSerial only holds 64 bytes and each echo is up to 5).
+	while (_volumeStepsToSend > 0 && _volumeStepsInFlight < _volumeStepWindow && _transport->transmitSpace() >= 2)
+	{
+		if (_activeArgument > _volume)
+		{
+			sendText(F("+\n"));
+		}
+		else
+		{
+			sendText(F("-\n"));
+		}
+		_volumeStepsToSend--;
+		_volumeStepsInFlight++;
+	}
+}
+
+void VS1000UART::processVolumeStep()
+{
+	if (!_tokenizer.startsWithNumber())
+	{
+		return;
+	}
+
+	// Each echo restarts the time out, so the time out is for one step and not the whole volume change.
+	recordResponseTime(TIMEOUTVOLUME, millis() - _commandStartTime);
+	_pipelineVolume		= _tokenizer.firstNumber();
+	_commandStartTime	= millis();
+	if (_volumeStepsInFlight > 0)
+	{
+		_volumeStepsInFlight--;
+	}
+
+	if (_volumeStepsToSend > 0 || _volumeStepsInFlight > 0)
+	{
+		sendVolumeSteps();
+		return;
+	}
+
+	// All steps are back.  If the chip's step is smaller than expected we came up short, so go again from where the chip is.  Stop if
+	// the last round didn't move the volume (the chip is at its limit) so we can't get stuck.
+	bool shortOfTarget = _activeArgument > _volume ? _pipelineVolume < _activeArgument : _pipelineVolume > _activeArgument;
+	if (shortOfTarget && _pipelineVolume != _pipelineStartVolume)
+	{
+		_pipelineStartVolume	= _pipelineVolume;
+		_volumeStepsToSend		= (abs(_activeArgument - _pipelineVolume) + _chipVolumeStep - 1) / _chipVolumeStep;
+		sendVolumeSteps();
+		return;
+	}
+
+	// Only the final volume is stored.
+	_volume = _pipelineVolume;
+	completeCommand(STATUSSUCCESS);
+}
+
+void VS1000UART::updateActivity()
+{
+	// The pin means nothing while the chip is held in reset.
+	if (_activityPin < 0 || _heldInReset || (_activityInterrupt && !_activityChanged))
+	{
+		return;
+	}
+
+	// ACT changes as soon as a play, pause or stop takes effect, before its answer is read.  It is left alone until the command is
+	// done, a change seen by the interrupt meanwhile is kept for then.
+	switch (_activeCommand)
+	{
+		case COMMANDPLAYNUMBER:
+		case COMMANDPLAYNAME:
+		case COMMANDPLAYARMED:
+		case COMMANDPAUSE:
+		case COMMANDSTOP:
+			return;
+
+		default:
+			break;
+	}
+	_activityChanged = false;
+
+	// ACT is low while playing.  It goes high when paused, which isn't the end of a track.
+	if (digitalRead(_activityPin) == LOW)
+	{
+		if (!_paused)
+		{
+			_playing = true;
+		}
+	}
+	else if (_playing && !_paused)
+	{
+		// ACT takes a moment to go low after a play is answered, so high doesn't count until then.  It is read again afterwards,
+		// a track that short has already ended and there won't be another interrupt.
+		if (millis() - _playStartTime <= _activityStartTime)
+		{
+			_activityChanged = true;
+			return;
+		}
+
+		_playing = false;
+
+		if (_playlistActive)
+		{
+			_playlistNext = true;
+		}
+
+		#if VS1000PERSISTENCE
+		markStateDirty();
+		#endif
+
+		if (_trackEndCallback)
+		{
+			_trackEndCallback();
+		}
+	}
+}
+
+#if VS1000PROGRESS
+uint32_t VS1000UART::progressElapsed(unsigned long sampleTime)
+{
+	return isPlaying() ? millis() - sampleTime : 0;
+}
+
+uint32_t VS1000UART::interpolatedPosition()
+{
+	return _progressPosition + progressElapsed(_progressTime);
+}
+
+uint32_t VS1000UART::interpolatedRemainingBytes()
+{
+	// Until two answers have been seen, the byte rate is estimated from the track size and length.
+	uint32_t byteRate = _byteRate;
+	if (byteRate == 0 && _progressValid && _totalTime > 0)
+	{
+		byteRate = _totalBytes / _totalTime;
+	}
+
+	// Split up so it doesn't overflow.
+	uint32_t elapsed	= progressElapsed(_sizeTime);
+	uint32_t played		= byteRate * (elapsed / 1000) + byteRate * (elapsed % 1000) / 1000;
+
+	return played < _remainingBytes ? _remainingBytes - played : 0;
+}
+#endif
+
+void VS1000UART::updatePlaylist()
+{
+	if (!_playlistActive || _playlistAdvancing)
+	{
+		return;
+	}
+
+	if (_playlistNext)
+	{
+		uint8_t position = nextPlaylistPosition();
+		if (position >= _playlistLength)
+		{
+			_playlistActive = false;
+			return;
+		}
+
+		// If the queue is full, try again on the next poll.
+		if (queueCommand(COMMANDPLAYNUMBER, _playlist[position]))
+		{
+			_playlistPosition	= position;
+			_playlistNext		= false;
+			_playlistAdvancing	= true;
+		}
+		return;
+	}
+
+	// Without the activity pin, the end of the track is found by asking for the play time when nothing else is going on.
+	if (_activityPin < 0 && isIdle() && millis() - _playlistCheckTime >= _playlistCheckDelay)
+	{
+		_playlistCheckTime = millis();
+		queueCommand(COMMANDPLAYTIME);
+	}
+}
+
+uint8_t VS1000UART::nextPlaylistPosition()
+{
+	switch (_playlistMode)
+	{
+		case PLAYLISTLOOP:
+			return _playlistPosition == _playlistNotStarted ? 0 : (_playlistPosition + 1) % _playlistLength;
+
+		case PLAYLISTSHUFFLE:
+			if (_playlistPosition == _playlistNotStarted || _playlistLength == 1)
+			{
+				return random(_playlistLength);
+			}
+			return (_playlistPosition + 1 + random(_playlistLength - 1)) % _playlistLength;
+
+		default:
+			return _playlistPosition == _playlistNotStarted ? 0 : _playlistPosition + 1;
+	}
+}
+
+void VS1000INTERRUPTHANDLER VS1000UART::activityInterrupt0()
+{
+	_activityInstances[0]->_activityChanged = true;
+}
+
+void VS1000INTERRUPTHANDLER VS1000UART::activityInterrupt1()
+{
+	_activityInstances[1]->_activityChanged = true;
+}
+
+void VS1000INTERRUPTHANDLER VS1000UART::activityInterrupt2()
+{
+	_activityInstances[2]->_activityChanged = true;
+}
+
+void VS1000INTERRUPTHANDLER VS1000UART::activityInterrupt3()
+{
+	_activityInstances[3]->_activityChanged = true;
+}
+
+void VS1000UART::processBootLine()
+{
+	#if VS1000DEBUG
+	if (_debugOutput)
+	{
+		_debugOutput(1, F("Audio chip: "), _lineBuffer);
+	}
+	#endif
+
+	_bootLineCount++;
+
+	// Boot messages are the banner, "Adafruit FX Sound Board 9/10/14", then the file system and number of files.  Finish at the
+	// number of files instead of waiting.  Only the start of the banner is checked because a small line buffer cuts it off.
+	if (_tokenizer.found(VS1000Tokenizer::KEYWORDBANNER))
+	{
+		_bootBannerFound	= true;
+		_bootLineCount		= 1;
+		return;
+	}
+
+	// The count is the number at the end of the line.
+	if (_tokenizer.found(VS1000Tokenizer::KEYWORDFILES) && _tokenizer.numberCount() > 0)
+	{
+		_bootFileCount = _tokenizer.lastNumber();
+	}
+
+	if (_bootFileCount >= 0 || (_bootBannerFound && _bootLineCount == 3))
+	{
+		_bootTime = millis() - _commandStartTime;
+		completeCommand(STATUSSUCCESS);
+	}
+}
+
+#if VS1000LISTING
+void VS1000UART::processListLine(uint8_t lineLength)
+{
+	// Each line restarts the time out.  Without the count from the reset, the listing is over when the lines stop coming.
+	_commandStartTime = millis();
+
+	// File names are 8.3 without the separating dot.
+	// Line returned is composed of file name, tab, zero padded right justified file size.
+	// Example: 04LATCHWAV	0000051892
+	// The size is the last number, a number in the name is before the tab.
+	uint32_t fileSize = _tokenizer.lastNumber();
+
+	if (_fileTable && _listedFileCount < _fileTableCapacity)
+	{
+		// Listing again after a reset keeps the lengths of files that are still the same.
+		FileEntry&	entry		= _fileTable[_listedFileCount];
+		uint16_t	nameHash	= hashFileName(_lineBuffer);
+		if (entry.nameHash != nameHash || entry.size != fileSize)
+		{
+			entry.nameHash	= nameHash;
+			entry.seconds	= 0;
+			entry.size		= fileSize;
+		}
+	}
+
+	// The size has been read, so the name can be terminated in the line buffer where the tab was and handed out from there.
+	if (lineLength > 11)
+	{
+		_lineBuffer[11] = 0;
+	}
+
+	if (_listFileNames && _listedFileCount < _listArrayLength)
+	{
+		memcpy(_listFileNames[_listedFileCount], _lineBuffer, 12);
+		_listFileSizes[_listedFileCount] = fileSize;
+	}
+
+	if (_fileCallback && !_fileCallbackStopped)
+	{
+		_fileCallbackStopped = !_fileCallback(_listedFileCount, _lineBuffer, fileSize);
+	}
+
+	if (_listedFileCount < 255)
+	{
+		_listedFileCount++;
+	}
+
+	// The chip said how many files it has when it started, so there is no need to wait for more.
+	if (_bootFileCount >= 0 && _listedFileCount >= _bootFileCount)
+	{
+		completeCommand(STATUSSUCCESS);
+	}
+}
+
+uint16_t VS1000UART::hashFileName(const char* fileName)
+{
+	// FNV-1a over the 11 name characters, folded to 16 bits.  The listing pads short names with spaces, so a shorter name is hashed
+	// as if it was padded too.
+	uint32_t	hash	= 2166136261UL;
+	bool		ended	= false;
+	for (uint8_t i = 0; i < 11; i++)
+	{
+		ended	= ended || !fileName[i];
+		hash	^= ended ? ' ' : (uint8_t)fileName[i];
+		hash	*= 16777619UL;
+	}
+
+	return (uint16_t)(hash >> 16) ^ (uint16_t)hash;
+}
+
+bool VS1000UART::sameFileName(const char* fileName1, const char* fileName2)
+{
+	bool ended1 = false;
+	bool ended2 = false;
+	for (uint8_t i = 0; i < 11; i++)
+	{
+		ended1 = ended1 || !fileName1[i];
+		ended2 = ended2 || !fileName2[i];
+		if ((ended1 ? ' ' : fileName1[i]) != (ended2 ? ' ' : fileName2[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#if VS1000PLAYBYNAME
+bool VS1000UART::checkPlayedName()
+{
+	_checkPlayName = false;
+
+	// The answer is "play", the number, and the name, each after a tab.  Without the name there is nothing to check.
+	const char* playedName = strrchr(_lineBuffer, '\t');
+	if (!playedName || playedName == strchr(_lineBuffer, '\t') || sameFileName(playedName + 1, _queuedFileName))
+	{
+		return true;
+	}
+
+	// If the table has the hash of the file that started, the name asked for only has the same hash.  If it doesn't, the files have
+	// changed since the table was made.
+	if (_activeArgument >= _fileTableCount || hashFileName(playedName + 1) != _fileTable[_activeArgument].nameHash)
+	{
+		_fileTableReady = false;
+		queueCommand(COMMANDLISTFILES);
+	}
+
+	// The wrong file is stopped first, so NoFile doesn't leave it playing.  The echo of the stop is skipped like any line before the
+	// answer, which completes the command.
+	_playing			= false;
+	_paused				= false;
+	_activeCommand		= COMMANDPLAYNAME;
+	_commandStartTime	= millis();
+	sendText(F("q\n"));
+	sendFrame('P', _queuedFileName, true);
+	return false;
+}
+#endif
+
+void VS1000UART::loadFileTable()
+{
+	if (!_fileTable)
+	{
+		return;
+	}
+
+	// A table kept while the chip was held in reset is still current if the number of files hasn't changed.
+	bool kept		= _fileTableKept;
+	_fileTableKept	= false;
+	if (kept && _bootFileCount == _fileTableCount)
+	{
+		_fileTableReady = true;
+		return;
+	}
+
+	// The saved table can be used if it is intact and the chip reports the same number of files.  If the chip didn't report the
+	// number of files, there is no way to know if the table is current.
+	#if VS1000PERSISTENCE
+	if (_storage && _fileTableAddress >= 0 && _bootFileCount >= 0)
+	{
+		uint8_t count = _storage->read(_fileTableAddress);
+		if (count == _bootFileCount && count <= _fileTableCapacity)
+		{
+			int address = _fileTableAddress + 3;
+			for (uint8_t i = 0; i < count; i++)
+			{
+				_storage->readBlock(address, &_fileTable[i].nameHash, 2);
+				_storage->readBlock(address + 2, &_fileTable[i].size, 4);
+				_storage->readBlock(address + 6, &_fileTable[i].seconds, 2);
+				address += _savedFileEntrySize;
+			}
+
+			_fileTableCount = count;
+			uint16_t checksum;
+			_storage->readBlock(_fileTableAddress + 1, &checksum, 2);
+			if (fileTableChecksum() == checksum)
+			{
+				_fileTableReady = true;
+				return;
+			}
+		}
+	}
+	#endif
+
+	queueCommand(COMMANDLISTFILES);
+}
+
+#if VS1000PERSISTENCE
+void VS1000UART::saveFileTable()
+{
+	// Update only writes the bytes that changed, so saving the same table again costs nothing.
+	uint16_t checksum = fileTableChecksum();
+	_storage->update(_fileTableAddress, _fileTableCount);
+	_storage->updateBlock(_fileTableAddress + 1, &checksum, 2);
+
+	int address = _fileTableAddress + 3;
+	for (uint8_t i = 0; i < _fileTableCount; i++)
+	{
+		_storage->updateBlock(address, &_fileTable[i].nameHash, 2);
+		_storage->updateBlock(address + 2, &_fileTable[i].size, 4);
+		_storage->updateBlock(address + 6, &_fileTable[i].seconds, 2);
+		address += _savedFileEntrySize;
+	}
+}
+#endif
+
+void VS1000UART::rememberTrackLength()
+{
+	// The answer is for the last track this class played.  A track started another way, such as a trigger pin, can't be told apart.
+	if (!_fileTableReady || _lastTrack >= _fileTableCount || _totalTime == 0 || _totalTime > 0xFFFF)
+	{
+		return;
+	}
+
+	FileEntry& entry = _fileTable[_lastTrack];
+	if (entry.seconds == _totalTime)
+	{
+		return;
+	}
+
+	// Written on its own, it isn't part of the check value, so the rest of the saved table doesn't change.
+	entry.seconds = _totalTime;
+	#if VS1000PERSISTENCE
+	if (_storage && _fileTableAddress >= 0)
+	{
+		_storage->updateBlock(_fileTableAddress + 3 + _savedFileEntrySize * _lastTrack + 6, &entry.seconds, 2);
+	}
+	#endif
+}
+
+uint16_t VS1000UART::fileTableChecksum()
+{
+	// Fletcher-16 over the name hash and size of each entry.
+	uint16_t sum1 = 0;
+	uint16_t sum2 = 0;
+	for (uint8_t i = 0; i < _fileTableCount; i++)
+	{
+		uint8_t bytes[6];
+		memcpy(bytes, &_fileTable[i].nameHash, 2);
+		memcpy(bytes + 2, &_fileTable[i].size, 4);
+		for (uint8_t j = 0; j < sizeof(bytes); j++)
+		{
+			sum1 = (sum1 + bytes[j]) % 255;
+			sum2 = (sum2 + sum1) % 255;
+		}
+	}
+
+	return (sum2 << 8) | sum1;
+}
+#endif
+
+void VS1000UART::startReset()
+{
+	// Reset by bringing the reset pin low.  First we have to switch the pin to output.  Then pull it low.  "poll" lets it go.
+	pinMode(_resetPin, OUTPUT);
+	digitalWrite(_resetPin, LOW);
+	_resetHolding		= true;
+	_bootBannerFound	= false;
+	_bootLineCount		= 0;
+	_bootFileCount		= -1;
+	_commandStartTime	= millis();
+	#if VS1000LISTING
+	_fileTableReady		= false;
+	#endif
+}
+
+bool VS1000UART::probeNextBaudRate()
+{
+	// The rate the reset started at has been tried already.
+	while (_baudAttempt < _probeBaudRateCount)
+	{
+		uint32_t baudRate = pgm_read_dword(&_probeBaudRates[_baudAttempt++]);
+		if (baudRate != _probeStartRate && _transport->setBaudRate(baudRate))
+		{
+			startReset();
+			return true;
+		}
+	}
+
+	_transport->setBaudRate(_probeStartRate);
+	return false;
+}
+
+VS1000UART::TIMEOUTCLASS VS1000UART::timeoutClassOf(COMMAND command)
+{
+	switch (command)
+	{
+		case COMMANDVOLUMEUP:
+		case COMMANDVOLUMEDOWN:
+		case COMMANDSETVOLUME:
+			return TIMEOUTVOLUME;
+
+		case COMMANDPLAYNUMBER:
+		case COMMANDPLAYNAME:
+		case COMMANDPLAYARMED:
+			return TIMEOUTPLAY;
+
+		case COMMANDPLAYTIME:
+		case COMMANDFILESIZE:
+			return TIMEOUTSTATUS;
+
+		case COMMANDLISTFILES:
+			return TIMEOUTLIST;
+
+		default:
+			return TIMEOUTTRANSPORT;
+	}
+}
+
+void VS1000UART::recordResponseTime(TIMEOUTCLASS timeoutClass, unsigned long responseTime)
+{
+	// Kept small enough that the scaled average can't overflow, and above 0 which means nothing measured.
+	int16_t sample = responseTime > 4000 ? 4000 : (responseTime < 1 ? 1 : responseTime);
+
+	if (_averageResponse[timeoutClass] == 0)
+	{
+		_averageResponse[timeoutClass]		= sample << 3;
+		_responseDeviation[timeoutClass]	= sample << 1;
+		return;
+	}
+
+	// Moves the average an eighth and the deviation a quarter of the way to the new sample, the same as TCP does for round trips.
+	int16_t difference				= sample - (_averageResponse[timeoutClass] >> 3);
+	_averageResponse[timeoutClass]	+= difference;
+	if (difference < 0)
+	{
+		difference = -difference;
+	}
+	_responseDeviation[timeoutClass] += difference - (_responseDeviation[timeoutClass] >> 2);
+}
+
+void VS1000UART::sendPlayTimeWorkaround()
+{
+	// There seems to be a bug in the firmware.  If you call to playTime when a track is not playing, then call to list files the list files command fails.
+	// It's not known if the bug is from Adafruit or VSI.  This command is not in the VSI1000 data sheet, so it's either undocumented or added by Adafruit.
+	// As a work around, we can send a new line character and clear the buffer.
+	sendText(F("\n"));
+	_workaroundSent		= true;
+	_commandStartTime	= millis();
+}
+
+void VS1000UART::completeCommand(COMMANDSTATUS status)
+{
+	COMMAND command	= _activeCommand;
+	_activeCommand	= COMMANDNONE;
+	_commandStatus	= status;
+	_playArmed		= false;
+
+	#if VS1000STATISTICS
+	if (_statistics)
+	{
+		_statistics->recordCommand(command, status, micros() - _commandStartMicros);
+	}
+	#endif
+
+	// The volume steps are measured as they come in, the listing and the reset aren't timed by their answers.  An answer after the
+	// play time work around doesn't say how long the chip took.
+	if (status == STATUSSUCCESS && !_workaroundSent && command != COMMANDSETVOLUME && command != COMMANDLISTFILES && command != COMMANDRESET)
+	{
+		recordResponseTime(timeoutClassOf(command), millis() - _commandStartTime);
+	}
+
+	// After restarting the chip, the volumes need to by synchronized and the file table filled.  A chip brought back by the watchdog
+	// gets the volume it had before, which replaces the saved volume queued by the synch.
+	if (command == COMMANDRESET && status == STATUSSUCCESS)
+	{
+		_recovering				= _chipDown;
+		_chipDown				= false;
+		_consecutiveTimeouts	= 0;
+
+		synchVolumes(true);
+		if (_recovering)
+		{
+			queueCommand(COMMANDSETVOLUME, _heldVolume);
+		}
+		#if VS1000LISTING
+		loadFileTable();
+		#endif
+	}
+
+	// Keep track of what is playing.
+	bool stateChanged = false;
+	if (status == STATUSSUCCESS)
+	{
+		switch (command)
+		{
+			case COMMANDPLAYNUMBER:
+			case COMMANDPLAYNAME:
+			case COMMANDPLAYARMED:
+			case COMMANDSTOP:
+			case COMMANDRESET:
+				// The cached progress was for the last track.
+				_playing		= command != COMMANDSTOP && command != COMMANDRESET;
+				_paused			= false;
+				_playStartTime	= millis();
+				#if VS1000PROGRESS
+				_progressValid	= false;
+				_sizeValid		= false;
+				_byteRate		= 0;
+				#endif
+
+				// The saved state is kept through a reset, so it can be restored after one.
+				stateChanged	= command != COMMANDRESET;
+
+				// The length of a track is learned from the play time, see "FileEntry."
+				#if VS1000LISTING
+				_trackLengthWanted	= _playing && _fileTableReady && _lastTrack < _fileTableCount && _fileTable[_lastTrack].seconds == 0;
+				#endif
+				break;
+
+			case COMMANDPAUSE:
+				// Move the cached progress up to now, it doesn't move while paused.
+				#if VS1000PROGRESS
+				_progressPosition	= interpolatedPosition();
+				_remainingBytes		= interpolatedRemainingBytes();
+				_progressTime		= millis();
+				_sizeTime			= millis();
+				#endif
+				_paused				= true;
+				stateChanged		= true;
+				break;
+
+			case COMMANDRESUME:
+				#if VS1000PROGRESS
+				_progressTime		= millis();
+				_sizeTime			= millis();
+				#endif
+				_paused				= false;
+				stateChanged		= true;
+				break;
+
+			case COMMANDPLAYTIME:
+				#if VS1000PROGRESS
+				_progressPosition	= _currentTime * 1000;
+				_progressTime		= millis();
+				_progressValid		= true;
+				#endif
+				// Any answer since the play has the length, so it needn't be asked for again.
+				#if VS1000LISTING
+				rememberTrackLength();
+				_trackLengthWanted	= false;
+				#endif
+				break;
+
+			#if VS1000PROGRESS
+			case COMMANDFILESIZE:
+				_sizeTime			= millis();
+				_sizeValid			= true;
+				break;
+			#endif
+
+			default:
+				break;
+		}
+	}
+	else if ((command == COMMANDPLAYTIME || command == COMMANDFILESIZE) && _activityPin < 0)
+	{
+		// Without the activity pin, no answer is the only sign that nothing is playing.
+		_playing = false;
+	}
+
+	// Follow the playlist.  Anything else played or stopped ends it.
+	if (_playlistActive)
+	{
+		switch (command)
+		{
+			case COMMANDPLAYNUMBER:
+				if (!_playlistAdvancing || status != STATUSSUCCESS)
+				{
+					_playlistActive = false;
+					break;
+				}
+
+				_playlistAdvancing	= false;
+				_playlistCheckTime	= millis();
+				_playlistCheckDelay	= _playlistCheckInterval;
+
+				if (_trackCallback)
+				{
+					_trackCallback(_playlistPosition, _playlist[_playlistPosition]);
+				}
+				break;
+
+			case COMMANDPLAYNAME:
+			case COMMANDPLAYARMED:
+			case COMMANDSTOP:
+			case COMMANDRESET:
+				_playlistActive = false;
+				break;
+
+			case COMMANDPLAYTIME:
+				if (_activityPin >= 0 || _playlistAdvancing)
+				{
+					break;
+				}
+
+				// Ask more often in the last second so the end is seen sooner.
+				if (status != STATUSSUCCESS)
+				{
+					_playlistNext = true;
+				}
+				else if (_currentTime + 1 >= _totalTime)
+				{
+					_playlistCheckDelay = _playlistEndCheckInterval;
+				}
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	// Volume changes are saved, except the volume up used to read the volume when synching.
+	if (status == STATUSSUCCESS && (command == COMMANDSETVOLUME || ((command == COMMANDVOLUMEUP || command == COMMANDVOLUMEDOWN) && _activeArgument != _volumeNotSaved)))
+	{
+		#if VS1000PERSISTENCE
+		saveVolumeToMemory();
+		#endif
+		stateChanged = true;
+	}
+
+	#if VS1000LISTING
+	if (command == COMMANDLISTFILES)
+	{
+		_fileCallback	= NULL;
+		_listFileNames	= NULL;
+		_listFileSizes	= NULL;
+	}
+
+	// A file listing fills the table as it goes.
+	if (command == COMMANDLISTFILES && _fileTable)
+	{
+		_fileTableCount = _listedFileCount < _fileTableCapacity ? _listedFileCount : _fileTableCapacity;
+		_fileTableReady = true;
+
+		#if VS1000PERSISTENCE
+		if (_storage && _fileTableAddress >= 0)
+		{
+			saveFileTable();
+		}
+		#endif
+	}
+	#endif
+
+	// Saved once everything above has been updated, a stop also ends the playlist.
+	#if VS1000PERSISTENCE
+	if (stateChanged)
+	{
+		markStateDirty();
+	}
+	#else
+	(void)stateChanged;
+	#endif
+
+	// A reset that times out doesn't count, the watchdog does its own.
+	if (status == STATUSTIMEDOUT && command != COMMANDRESET && _watchdogTimeouts > 0 && !_chipDown)
+	{
+		if (++_consecutiveTimeouts >= _watchdogTimeouts)
+		{
+			markChipDown();
+		}
+	}
+
+	// Called last so the callback can queue more commands.
+	if (_commandCallback)
+	{
+		_commandCallback(command, status);
+	}
+}
+
+bool VS1000UART::readLineByte(char character)
+{
+	if (!_tokenizer.add(character))
+	{
+		return false;
+	}
+
+	#if VS1000DEBUG
+	if (_debugOutput)
+	{
+		_debugOutput(2, F("Line buffer: "), _lineBuffer);
+	}
+	#endif
+
+	return true;
+}
+
+void VS1000UART::sendText(const __FlashStringHelper* text)
+{
+	// Copy out of flash memory a piece at a time.
+	const char*	characters	= (const char*)text;
+	uint8_t		buffer[VS1000TRANSMITBUFFERSIZE];
+	uint8_t		length		= 0;
+
+	while ((buffer[length] = pgm_read_byte(characters + length)) != 0 && length < VS1000TRANSMITBUFFERSIZE - 1)
+	{
+		length++;
+	}
+
+	_transport->write(buffer, length);
+}
+
+void VS1000UART::sendFrame(char command, const char* text, bool endLine)
+{
+	// Built whole and handed to the transport in one write, so a command is never split across polls.
+	uint8_t	frame[VS1000TRANSMITBUFFERSIZE];
+	uint8_t	length	= 0;
+
+	frame[length++] = command;
+	while (*text != 0 && length < VS1000TRANSMITBUFFERSIZE - 1)
+	{
+		frame[length++] = *text++;
+	}
+
+	if (endLine)
+	{
+		frame[length++] = '\n';
+	}
+
+	_transport->write(frame, length);
+}
+
+VS1000UART::VOLUMELEVEL VS1000UART::nextCycleLevel(VOLUMELEVEL level)
+{
+	return level >= _maximumLevel ? _minimumLevel : (VOLUMELEVEL)(level + 1);
+}
+
+VS1000UART::VOLUMELEVEL VS1000UART::calculateLevelFromVolume(uint8_t volume)
+{
+	// Binary search for the first level at or above the volume, then take the closer of it and the level below.  A volume halfway
+	// between goes up, the same as rounding.  Volumes outside the minimum and maximum give the minimum or maximum level.
+	uint8_t lower = _minimumLevel;
+	uint8_t upper = _maximumLevel;
+	while (lower < upper)
+	{
+		uint8_t middle = (lower + upper) / 2;
+		if (_levelVolumes[middle] < volume)
+		{
+			lower = middle + 1;
+		}
+		else
+		{
+			upper = middle;
+		}
+	}
+
+	if (lower > _minimumLevel && volume - _levelVolumes[lower - 1] < _levelVolumes[lower] - volume)
+	{
+		lower--;
+	}
+
+	return (VOLUMELEVEL)lower;
+}
+
+uint8_t VS1000UART::calculateVolumeFromLevel(VOLUMELEVEL level)
+{
+	if (level > _maximumLevel)
+	{
+		level = _maximumLevel;
+	}
+
+	if (level < _minimumLevel)
+	{
+		level = _minimumLevel;
+	}
+
+	return _levelVolumes[level];
+}
+
+void VS1000UART::buildLevelTable()
+{
+	// Calculate the volume of each level from the curve.  Levels outside the minimum and maximum are never looked up, but are filled
+	// in so the table is always valid.
+	int16_t levelRange = _maximumLevel - _minimumLevel;
+	for (uint8_t level = VOLUME0; level <= VOLUME10; level++)
+	{
+		if (levelRange == 0 || level <= _minimumLevel)
+		{
+			_levelVolumes[level] = _minimumVolume;
+		}
+		else if (level >= _maximumLevel)
+		{
+			_levelVolumes[level] = _maximumVolume;
+		}
+		else if (_volumeCurve == NULL)
+		{
+			_levelVolumes[level] = roundedDivide((int32_t)(level - _minimumLevel) * (_maximumVolume - _minimumVolume), levelRange) + _minimumVolume;
+		}
+		else
+		{
+			// Spread the levels in use over the whole curve, interpolating between its points.
+			uint8_t		point		= (level - _minimumLevel) * VOLUME10 / levelRange;
+			uint8_t		remainder	= (level - _minimumLevel) * VOLUME10 % levelRange;
+			int16_t		position	= pgm_read_byte(&_volumeCurve[point]);
+			if (remainder > 0)
+			{
+				position += roundedDivide((int32_t)(pgm_read_byte(&_volumeCurve[point + 1]) - position) * remainder, levelRange);
+			}
+			// The low end of a curve can put levels less than a chip step apart, rounding up to a step keeps them apart.  Past a maximum
+			// that isn't on a step, the step below it is taken instead.
+			uint16_t volume			= roundedDivide((int32_t)position * (_maximumVolume - _minimumVolume), 255) + _minimumVolume;
+			volume					= (volume + _chipVolumeStep - 1) / _chipVolumeStep * _chipVolumeStep;
+			_levelVolumes[level]	= volume <= _maximumVolume ? volume : _maximumVolume / _chipVolumeStep * _chipVolumeStep;
+		}
+	}
+}
+
+int16_t VS1000UART::roundedDivide(int32_t numerator, int16_t denominator)
+{
+	// Rounds halves away from zero, like "round."
+	if (denominator < 0)
+	{
+		numerator	= -numerator;
+		denominator	= -denominator;
+	}
+
+	if (numerator < 0)
+	{
+		return -((-2 * numerator + denominator) / (2 * denominator));
+	}
+
+	return (2 * numerator + denominator) / (2 * denominator);
+}
+
+void VS1000UART::synchVolumes(bool booted)
+{
+	// We need to initialize the "_volume" variable before a call to "setVolume."  A chip that just booted is at its boot volume.
+	// Otherwise, we will queue a volume up and the answer will set the variable.  Do not save the volume or we overwrite the value we
+	// are trying to restore.
+	if (booted && _bootVolume >= 0)
+	{
+		_volume = _bootVolume;
+	}
+	else
+	{
+		queueCommand(COMMANDVOLUMEUP, _volumeNotSaved);
+	}
+
+	// Read the volume from memory.  Then calculate and set a new volume level.  The steps are worked out when the command
+	// starts, which is after the volume up has answered.
+	#if VS1000PERSISTENCE
+	uint8_t volume;
+	if (_persistentVolume && readVolumeFromMemory(&volume))
+	{
+		queueCommand(COMMANDSETVOLUME, calculateVolumeFromLevel(calculateLevelFromVolume(volume)));
+	}
+	#endif
+}
+
+bool VS1000UART::volumeUpWithoutSaving()
+{
+	return runCommand(COMMANDVOLUMEUP, _volumeNotSaved);
+}
+
+bool VS1000UART::volumeDownWithoutSaving()
+{
+	return runCommand(COMMANDVOLUMEDOWN, _volumeNotSaved);
+}
+
+bool VS1000UART::readVolumeFromChip()
+{
+	if (!_tokenizer.startsWithNumber())
+	{
+		return false;
+	}
+
+	_volume = _tokenizer.firstNumber();
+	return true;
+}
+
+#if VS1000PERSISTENCE
+void VS1000UART::saveVolumeToMemory()
+{
+	// When we have volume saving enabled, we save it to the flash memory on the Arduino.  With a delay, the save is done by "poll"
+	// once the volume stops changing.
+	if (_persistentVolume)
+	{
+		_volumeDirty		= true;
+		_volumeChangeTime	= millis();
+
+		if (_volumeSaveDelay == 0)
+		{
+			commitVolumeToMemory();
+		}
+	}
+}
+
+void VS1000UART::commitVolumeToMemory()
+{
+	_volumeDirty = false;
+
+	if (_volume == _savedVolume)
+	{
+		return;
+	}
+
+	// Each slot is the volume followed by a sequence number.  The next slot has the next sequence number, so the newest slot is the
+	// one the sequence breaks after.  The volume is written first so a slot only looks new once it is complete.  Only one byte each
+	// is written, and only if it changed.
+	_volumeSlot		= (_volumeSlot + 1) % _volumeMemorySlots;
+	_volumeSequence++;
+
+	int address = _memoryAddress + 2 * _volumeSlot;
+	_storage->update(address, _volume);
+	_storage->update(address + 1, _volumeSequence);
+
+	_savedVolume = _volume;
+}
+
+bool VS1000UART::readVolumeFromMemory(uint8_t* volume)
+{
+	// Find the slot the sequence breaks after.  An erased memory has the same sequence number in every slot, so slot 0 is picked and
+	// the volume of 255 is rejected below.  A volume saved by older versions (an int) looks like slot 0 with sequence number 0.
+	_volumeSlot		= 0;
+	_volumeSequence	= _storage->read(_memoryAddress + 1);
+	for (uint8_t i = 1; i < _volumeMemorySlots; i++)
+	{
+		uint8_t sequence = _storage->read(_memoryAddress + 2 * i + 1);
+		if (sequence != (uint8_t)(_volumeSequence + 1))
+		{
+			break;
+		}
+		_volumeSlot		= i;
+		_volumeSequence	= sequence;
+	}
+
+	*volume			= _storage->read(_memoryAddress + 2 * _volumeSlot);
+	_savedVolume	= *volume;
+
+	return *volume <= _chipMaxVolume;
+}
+
+void VS1000UART::markStateDirty()
+{
+	if (_stateAddress < 0 || !_stateRestored)
+	{
+		return;
+	}
+
+	// Written by "poll" after the delay.
+	_stateDirty			= true;
+	_stateChangeTime	= millis();
+}
+
+void VS1000UART::commitState()
+{
+	_stateDirty = false;
+
+	StateSnapshot snapshot;
+	snapshot.version			= _stateVersion;
+	snapshot.volume				= _volume;
+	snapshot.minimumVolume		= _minimumVolume;
+	snapshot.maximumVolume		= _maximumVolume;
+	snapshot.minimumLevel		= _minimumLevel;
+	snapshot.maximumLevel		= _maximumLevel;
+	snapshot.fileCount			= (uint8_t)_bootFileCount;
+	snapshot.track				= _lastTrack;
+	snapshot.playlistLength		= _playlistLength;
+	snapshot.playlistPosition	= _playlistPosition;
+	snapshot.playlistMode		= _playlistMode;
+	snapshot.flags				= (_playing ? _statePlaying : 0) | (_playing && _paused ? _statePaused : 0) | (_playlistActive ? _statePlaylist : 0);
+	snapshot.sequence			= ++_stateSequence;
+	#if VS1000LISTING
+	snapshot.fileTableChecksum	= _fileTableReady ? fileTableChecksum() : 0;
+	#else
+	snapshot.fileTableChecksum	= 0;
+	#endif
+	snapshot.playlistChecksum	= _playlist ? stateChecksum(_playlist, _playlistLength) : 0;
+	snapshot.check				= stateChecksum((const uint8_t*)&snapshot, sizeof(snapshot) - 2);
+
+	// The next slot.  Bytes that are the same as the snapshot saved there before are left alone by the update.
+	_stateSlot = (_stateSlot + 1) % _stateSlots;
+	_storage->updateBlock(_stateAddress + _stateSlot * sizeof(StateSnapshot), &snapshot, sizeof(snapshot));
+}
+
+uint16_t VS1000UART::stateChecksum(const uint8_t* bytes, uint8_t length)
+{
+	// CRC-16/CCITT-FALSE, a bit at a time so no table is needed.
+	uint16_t crc = 0xFFFF;
+	for (uint8_t i = 0; i < length; i++)
+	{
+		crc ^= (uint16_t)bytes[i] << 8;
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+
+	return crc;
+}
+#endif
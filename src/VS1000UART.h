@@ -19,6 +19,41 @@
 	- Added persistent volume.
 		Allows saving the set volume level to the Arduinos EEPROM memory and having it restored on start up.
 	- Added debugging levels for printing output.
+		Set with the "VS1000UARTStatic" template, which also puts the line buffer in the object instead of on the heap and only
+		builds in saving to EEPROM when it is used.
+	- Added an asynchronous command engine.
+		Commands can be queued and return immediately.  Calling "poll" from the main loop sends them and parses the responses without
+		blocking.  The blocking functions are built on top of the engine.
+	- Added an optional file table.
+		After a reset the files are listed once into a caller supplied table of name hashes and sizes.  Playing by name is then looked
+		up locally and sent as a play by number.  The table can be saved to memory so it is only listed again when the files change.
+		The length of each file is learned the first time its play time is read, so sizes and lengths can be shown without asking.
+	- Added play state tracking with the ACT pin.
+		"isPlaying" is answered from the pin instead of the chip, the end of a track can be signalled with a callback, and the
+		play time is not asked for when nothing is playing.
+	- Added continuous play mode.
+		Plays a playlist once, looped, or shuffled, starting each track from "poll" as soon as the last one ends.
+	- Added "VS1000Group" for driving several boards.
+		Commands are queued on every board in one pass and answered in parallel.  A synchronized play holds back the end of the
+		line until every board has the rest, so the boards start together.
+	- Added per command time outs and baud probing.
+		Each kind of command has its own time out, optionally tightened to the measured answer times.  A reset can find the baud
+		rate of a board with firmware that doesn't run at 9600.
+	- Added power saving.
+		The blocking functions can sleep the processor while waiting, and the chip can be held in reset while nothing plays, then
+		released with its volume and file table restored.
+	- Added "VS1000Input" for buttons and rotary encoders.
+		Controls are debounced and bound to actions that are queued, so held buttons and fast turns become one volume change.
+	- Added volume curves.
+		Levels can be spread linearly, logarithmically, or by a curve in PROGMEM supplied by the sketch.
+	- Added a snapshot of the player state.
+		The volume, level limits, last track, and playlist position are saved with a CRC as they change, in slots that take turns to
+		spread the wear, and "restoreState" plays on from where the player was before a restart.
+	- Added "VS1000Task" for the ESP32 and RP2040.
+		One task or core drives the board, the others post requests that never block and can wait on a ticket.
+	- Added build switches.
+		Saving, play by name, listing, the progress queries, and debugging output can each be left out for small boards, see
+		"VS1000Config.h."  "extras/footprint" reports the flash and RAM of each example with each of them.
 
 	Bug fixes and other improvements:
 	- More comments to explain code and document behavior.
@@ -30,6 +65,10 @@
 	- Removed storage of file names, file sizes, and number of files.  This was only used to return names and sizes for the example created by Adafruit.  By
 		having the storage arrays passed into the list files function, they can be removed from the class and use less memory when not in use.
 	- Code style far more consistent and readable.
+	- "fileSize" never read the answer from the chip.  It now does, and "playTime" and "fileSize" reuse their last answer for a short
+		time, moving it along locally, so they can be called often for a progress display.
+	- Everything the chip sends is read, instead of throwing away what is waiting before each command.  A late answer is no longer
+		taken as the answer to the next command, and a chip that restarted on its own is set up again.
 */
 
 /*!
@@ -62,13 +101,15 @@
 #define VS1000UART_H
 
 #include <Arduino.h>
-#include <EEPROMex.h>
+#include "VS1000Config.h"
+#include "VS1000Storage.h"
+#include "VS1000StreamTransport.h"
+#include "VS1000Tokenizer.h"
 
-// Debugging output to the serial monitor.  Set the value to specify the amount of messages.
-// 0 - No messages.
-// 1 - Basic messages (boot up).
-// 2 - Additional messages (line buffer).
-#define VS1000DEBUGLEVEL	0
+// Number of commands that can be waiting in the queue of the asynchronous command engine.
+#define VS1000COMMANDQUEUESIZE	4
+
+class VS1000Statistics;
 
 /// \brief Class that stores the state and functions of the soundboard object.
 class VS1000UART
@@ -90,6 +131,114 @@ class VS1000UART
 			VOLUME10
 		};
 
+		/// \brief How the levels are spread between the minimum and maximum volume, see "setVolumeCurve."
+		enum VOLUMECURVE : uint8_t
+		{
+			CURVELINEAR,
+			CURVELOGARITHMIC
+		};
+
+		/// \brief Commands that can be queued for the audio chip.
+		enum COMMAND : uint8_t
+		{
+			COMMANDNONE,
+			COMMANDPLAYNUMBER,
+			COMMANDPLAYNAME,
+			COMMANDVOLUMEUP,
+			COMMANDVOLUMEDOWN,
+			COMMANDPAUSE,
+			COMMANDRESUME,
+			COMMANDSTOP,
+			COMMANDPLAYTIME,
+			COMMANDSETVOLUME,
+			COMMANDRESET,
+			COMMANDLISTFILES,
+			COMMANDFILESIZE,
+			COMMANDPLAYARMED
+		};
+
+		/// \brief Status of the active or most recently completed command.
+		enum COMMANDSTATUS : uint8_t
+		{
+			STATUSIDLE,
+			STATUSPENDING,
+			STATUSSUCCESS,
+			STATUSFAILED,
+			STATUSTIMEDOUT
+		};
+
+		/// \brief How a playlist is played in continuous play mode.
+		enum PLAYLISTMODE : uint8_t
+		{
+			PLAYLISTONCE,
+			PLAYLISTLOOP,
+			PLAYLISTSHUFFLE
+		};
+
+		/// \brief Kinds of commands that each have their own time out, see "setTimeout."
+		enum TIMEOUTCLASS : uint8_t
+		{
+			TIMEOUTVOLUME,
+			TIMEOUTTRANSPORT,
+			TIMEOUTPLAY,
+			TIMEOUTSTATUS,
+			TIMEOUTLIST,
+			TIMEOUTCOUNT
+		};
+
+		/// \brief Function called when a queued command completes.
+		/// \param command The command that completed.
+		/// \param status How the command completed.
+		typedef void (*CommandCallback)(COMMAND command, COMMANDSTATUS status);
+
+		/// \brief Lines from the chip that don't answer the active command.
+		enum EVENT : uint8_t
+		{
+			EVENTREBOOT,
+			EVENTLATEANSWER,
+			EVENTUNKNOWNLINE,
+			EVENTCHIPDOWN,
+			EVENTRECOVERED
+		};
+
+		/// \brief Function called for a line from the chip that doesn't answer the active command, or when the watchdog finds the chip
+		/// down or has brought it back, see "useWatchdog."
+		/// \param event What the line was taken as.  After EVENTREBOOT the rest of the boot is handled as a COMMANDRESET.
+		/// \param line The line, empty for the watchdog events.  Only valid during the call.
+		typedef void (*EventCallback)(EVENT event, const char* line);
+
+		/// \brief Function called when a track finishes playing on its own.
+		typedef void (*TrackEndCallback)();
+
+		/// \brief Function called when continuous play mode starts the next track of the playlist.
+		/// \param position Position in the playlist.
+		/// \param fileNumber Number of the file being played.
+		typedef void (*TrackCallback)(uint8_t position, uint8_t fileNumber);
+
+		/// \brief Function that prints debugging messages.  See "VS1000UARTStatic" for the debugging levels.
+		/// \param level Level of the message.
+		/// \param label Label printed first.
+		/// \param text Text printed after the label.
+		typedef void (*DebugOutput)(uint8_t level, const __FlashStringHelper* label, const char* text);
+
+		#if VS1000LISTING
+		/// \brief Function called for each file in a listing.
+		/// \param fileNumber Number of the file, as used to play by number.
+		/// \param fileName Name of the file, 8.3 without the dot.  Only valid during the call.
+		/// \param fileSize Size of the file in bytes.
+		/// \return Return true to keep going, false to stop at this file.
+		typedef bool (*FileCallback)(uint8_t fileNumber, const char* fileName, uint32_t fileSize);
+
+		/// \brief Entry in the file table.  The name is stored as a hash so each file only takes 8 bytes.  The length is learned the
+		/// first time the file plays, the play time is asked for once the class is idle after the play, and is 0 until then.
+		struct FileEntry
+		{
+			uint16_t				nameHash;
+			uint16_t				seconds;
+			uint32_t				size;
+		};
+		#endif
+
 	// Constructors.
 	public:
 		/// \brief Constructor that lets you provide your own serial communicate stream.
@@ -97,15 +246,41 @@ class VS1000UART
 		/// \param resetPin Reset pin.
 		VS1000UART(Stream* chipStream, int8_t resetPin);
 
+		#if VS1000PERSISTENCE
 		/// \brief Same as previous, but can save and restore the volume.
 		/// \param chipStream Pointer to the serial stream used to communicate with the chip.
 		/// \param resetPin Reset pin.
-		/// \param memoryAddress Memory address to save volume level.
+		/// \param memoryAddress Memory address to save volume level.  Uses 2 bytes for each slot, see "setVolumeMemorySlots."
 		VS1000UART(Stream* chipStream, int8_t resetPin, int memoryAddress);
+		#endif
+
+		/// \brief Constructor for a connection other than a Stream, e.g. VS1000HardwareSerialTransport.
+		/// \param transport Connection to the chip.  Must exist as long as the class.
+		/// \param resetPin Reset pin.
+		VS1000UART(VS1000Transport* transport, int8_t resetPin);
+
+		#if VS1000PERSISTENCE
+		/// \brief Same as previous, but can save and restore the volume.
+		/// \param transport Connection to the chip.  Must exist as long as the class.
+		/// \param resetPin Reset pin.
+		/// \param memoryAddress Memory address to save volume level.  Uses 2 bytes for each slot, see "setVolumeMemorySlots."
+		VS1000UART(VS1000Transport* transport, int8_t resetPin, int memoryAddress);
+		#endif
 
 		/// \brief Destructor.
 		~VS1000UART();
 
+	protected:
+		/// \brief Constructor for classes that supply their own line buffer and features.
+		/// \param transport Connection to the chip.
+		/// \param resetPin Reset pin.
+		/// \param lineBuffer Buffer for the lines read from the chip.  Must hold at least 23 characters.
+		/// \param lineBufferSize Size of the line buffer.
+		/// \param storage Memory used for saving, or NULL to never save.  Not used without VS1000PERSISTENCE.
+		/// \param memoryAddress Memory address to save volume level, or -1 to not save the volume.  Not used without VS1000PERSISTENCE.
+		/// \param debugOutput Function that prints debugging messages, or NULL for none.  Not used without VS1000DEBUG.
+		VS1000UART(VS1000Transport* transport, int8_t resetPin, char* lineBuffer, uint8_t lineBufferSize, VS1000Storage* storage, int memoryAddress, DebugOutput debugOutput);
+
 	// Functions to use in setup.
 	public:
 		/// \brief Sets a lower limit on the volume.  Useful to adjust the volume for a particular setup.
@@ -123,21 +298,158 @@ class VS1000UART
 		/// \brief Sets the maximum level.  For example, if only 5 increments of volume are required, it can be adjusted here.
 		void setMaximumLevel(VOLUMELEVEL volumeLevel);
 
-		/// \brief Last call to this class for use in the "Setup" function.
+		/// \brief Sets how the levels are spread between the minimum and maximum volume.  Linear, the default, puts them the same number
+		/// of volume steps apart, which sounds bunched up at the top.  Logarithmic makes each level a fixed ratio louder than the one
+		/// below, closer to how loudness is heard.
+		/// \param curve The curve.
+		void setVolumeCurve(VOLUMECURVE curve);
+
+		/// \brief Same as previous, but with a curve supplied by the sketch.
+		/// \param curve Array in PROGMEM of 11 values, one for each of VOLUME0 to VOLUME10, giving how far along from the minimum volume
+		/// (0) to the maximum volume (255) the level is.  Must not go down.  When fewer levels are used, the values in between levels
+		/// are interpolated.  Must exist as long as the class.
+		void setVolumeCurve(const uint8_t* curve);
+
+		#if VS1000PERSISTENCE
+		/// \brief Sets how long the volume has to stay the same before it is saved.  Turning a knob then only saves the volume it stops at.
+		/// The save is done by "poll," so with a delay "poll" has to be called from the main loop.
+		/// \param delay Time in milliseconds.  The default of 0 saves on every change.
+		void setVolumeSaveDelay(unsigned int delay);
+
+		/// \brief Sets how many memory slots the saved volume rotates through.  Each save goes to the next slot, which spreads the wear.
+		/// \param slots Number of 2 byte slots starting at the memory address.  The default is 8.
+		void setVolumeMemorySlots(uint8_t slots);
+		#endif
+
+		/// \brief Sets the pin connected to the ACT pin of the board, which is low while audio is playing.  This lets "isPlaying" answer
+		/// without asking the chip, and end of track be reported.  A pin with an external interrupt is watched by the interrupt, any
+		/// other pin is read by "poll."
+		/// \param activityPin Pin connected to ACT.
+		void setActivityPin(uint8_t activityPin);
+
+		/// \brief Sets a function to be called by "poll" when a track finishes playing on its own (not when stopped).  Needs the activity pin.
+		/// \param callback Function to call, or NULL for none.
+		void setTrackEndCallback(TrackEndCallback callback);
+
+		#if VS1000STATISTICS
+		/// \brief Sets where the timing of each command is recorded.
+		/// \param statistics Statistics to record into, or NULL to stop recording.
+		void setStatistics(VS1000Statistics* statistics);
+		#endif
+
+		/// \brief Sets the longest time to wait for the chip to boot after a reset.
+		/// \param timeout Time in milliseconds.
+		void setResetTimeout(unsigned int timeout);
+
+		/// \brief Sets the volume the chip starts at after a reset.  After a reset the volume is taken to be this instead of asking the
+		/// chip with a volume step, and a saved volume is restored with one pipelined volume change.  The Adafruit firmware starts at
+		/// 204, the default.
+		/// \param volume The boot volume, or -1 to ask the chip after each reset.
+		void setBootVolume(int16_t volume);
+
+		/// \brief Makes each reset find the baud rate the board talks at.  The rate in use is tried first, then 115200, 57600, 38400,
+		/// 19200, and 9600 until the boot messages are read.  Each wrong rate costs a reset time out.  If no rate works the connection
+		/// goes back to the rate it had and the reset times out.  Needs a connection that can change its rate, such as
+		/// VS1000HardwareSerialTransport.  The Adafruit firmware only talks at 9600, this is for boards with other firmware.
+		/// \param probe True to probe on each reset.
+		void useBaudProbing(bool probe);
+
+		/// \brief Makes the blocking functions sleep the processor between checks for an answer instead of spinning, see "sleep."
+		/// \param powerSaving True to sleep while waiting.
+		void usePowerSaving(bool powerSaving);
+
+		/// \brief Turns on the watchdog.  After a number of time outs in a row with nothing received in between, the chip is taken to be
+		/// down: commands still queued are dropped, along with a queued listing's callback and continuous play waiting for its next
+		/// track, new ones are refused, and the blocking functions return false right away instead of waiting out a time out each.
+		/// "poll" resets the chip in the background, once a second until it boots, then restores
+		/// the volume from before and reuses the file table if the chip has the same number of files.  EVENTCHIPDOWN and
+		/// EVENTRECOVERED are sent to the event callback.  Off by default.
+		/// \param timeouts Number of time outs in a row, or 0 to turn the watchdog off.
+		void useWatchdog(uint8_t timeouts);
+
+		/// \brief Sets how long to wait for the answer to a kind of command before giving up with STATUSTIMEDOUT.  The defaults are 200 ms
+		/// for the volume echo (per step when setting the volume), 200 ms for pause, resume, and stop, 500 ms for playing, 300 ms for the
+		/// play time and file size, and 1000 ms for the gap between the lines of a file listing.  A listing ends with the last of the
+		/// files counted by the chip at the reset, or with this time out when the count wasn't seen.
+		/// \param timeoutClass Kind of command.
+		/// \param timeout Time in milliseconds.  With adaptive time outs this is the longest time out used.
+		void setTimeout(TIMEOUTCLASS timeoutClass, unsigned int timeout);
+
+		/// \brief Gets the time out used for a kind of command, which with adaptive time outs is the one worked out so far.
+		/// \param timeoutClass Kind of command.
+		unsigned int getTimeout(TIMEOUTCLASS timeoutClass);
+
+		/// \brief Turns on adaptive time outs.  The time each kind of command takes to be answered is tracked and the time out is
+		/// tightened to the average plus four times the average deviation, never more than set with "setTimeout."  A chip that stops
+		/// answering is then found out quickly.  A time out starts the tracking of that kind over from the set time out.  The listing is
+		/// never tightened because its end can be found by timing out.
+		/// \param adaptive True to tighten the time outs to the measured times.
+		void useAdaptiveTimeouts(bool adaptive);
+
+		#if VS1000PROGRESS
+		/// \brief Sets how long answers to "playTime" and "fileSize" are reused for.  In between, they are moved along locally by how long
+		/// the track has been playing, so a progress display can call them often without asking the chip each time.  Defaults to 1000 ms.
+		/// \param interval Time in milliseconds, or 0 to ask the chip every time.
+		void setProgressRefresh(unsigned int interval);
+		#endif
+
+		#if VS1000LISTING
+		/// \brief Provides storage for a table of the files on the chip.  The table is filled from a file listing after each reset, then
+		/// playing by name is looked up locally and sent as the shorter play by number.  The answer to the play names the file that
+		/// started.  If it isn't the one asked for, it is stopped and the name is sent after all, which plays the right file or gives
+		/// NoFile, and if the table is out of date the files are listed again.  The wrong file is heard for the time it takes to answer.
+		/// \param fileTable Array to hold the table.  Must exist as long as the class.
+		/// \param capacity Number of entries in the array.
+		void useFileTable(FileEntry* fileTable, uint8_t capacity);
+
+		#if VS1000PERSISTENCE
+		/// \brief Same as previous, but the table is saved to memory so it only has to be listed again when the number of files changes.
+		/// Files swapped for as many others aren't seen at the reset, only when a play by name gets the wrong file, see above.
+		/// \param fileTable Array to hold the table.  Must exist as long as the class.
+		/// \param capacity Number of entries in the array.
+		/// \param memoryAddress Memory address to save the table.  Uses 3 bytes plus 8 bytes for each entry.  The lengths of the files are
+		/// saved as they are learned.
+		void useFileTable(FileEntry* fileTable, uint8_t capacity, int memoryAddress);
+		#endif
+		#endif
+
+		/// \brief Last call to this class for use in the "Setup" function.  Doesn't talk to the chip, call "reset" after it, which synchs
+		/// the volume with the chip and restores a saved volume.
 		void begin();
 
 	// Functions for controlling/interacting with the audio chip.
 	public:
-		/// \brief Hard reset of the chip.
-		/// \return Returns the output lines.
+		/// \brief Hard reset of the chip.  Returns as soon as the chip has finished printing its boot messages instead of waiting a fixed time.
+		/// \return Returns true if the chip printed its boot messages before the reset time out.
 		bool reset();
 
+		/// \brief Gets how long the chip took to boot on the last reset.
+		/// \return Time in milliseconds from releasing the reset pin to the last boot message.
+		unsigned long getBootTime();
+
+		/// \brief Checks if the "Adafruit FX Sound Board" boot banner was seen on the last reset.
+		bool bootBannerFound();
+
+		/// \brief Gets the baud rate of the connection, which after a reset with baud probing is the one the board was found at.
+		/// \return Returns the baud rate, or 0 if the connection doesn't know it.
+		unsigned long getBaudRate();
+
+		#if VS1000LISTING
 		/// \brief Query the board for the # of files and names/sizes.
-		/// \return Returns Number of files.
-		// uint8_t listFiles();
+		/// \param fileNames Array for the file names.
+		/// \param fileSizes Array for the file sizes.
+		/// \param arrayLength Number of entries in the arrays.  Files past the end are still read from the chip, but not stored.
+		/// \return Returns Number of files stored.
 		uint8_t listFiles(char fileNames[][12], uint32_t fileSizes[], uint8_t arrayLength);
 
-		/// \brief Raises the volume.
+		/// \brief Query the board for the files and pass each one to a function as it is read, so no arrays are needed.
+		/// \param callback Function called for each file.  If it returns false, this returns right away and the rest of the listing
+		/// is read and thrown away by "poll."
+		/// \return Returns Number of files passed to the callback.
+		uint8_t listFiles(FileCallback callback);
+		#endif
+
+		/// \brief Raises the volume.  If the chip doesn't answer the volume is left as it was and "getCommandStatus" returns STATUSTIMEDOUT.
 		/// \return Returns the current volume.
 		uint8_t volumeUp();
 
@@ -178,10 +490,33 @@ class VS1000UART
 		/// \return Returns true if the track was played.
 		bool playFile(uint8_t fileNumber);
 
-		/// \brief Play the specified track.
+		#if VS1000PLAYBYNAME
+		/// \brief Play the specified track.  If a file table is in use, the track is played by number.
 		/// \param name track name.
 		/// \return Returns true if the track was played.
-		bool playFile(char* fileName);
+		bool playFile(const char* fileName);
+		#endif
+
+		#if VS1000LISTING
+		/// \brief Looks up a file in the file table.  Only the hash of each name is kept, so a name that isn't on the chip is found if it
+		/// has the same hash as one that is, and a table from before files were swapped for others, as many, still has the old files.
+		/// Playing by name checks the name in the chip's answer for both.
+		/// \param fileName Track name.
+		/// \return Returns the file number, or -1 if the table isn't ready or the name isn't found (or isn't unique).
+		int16_t findFile(const char* fileName);
+
+		/// \brief Checks if the file table has been filled since the last reset.
+		bool fileTableReady();
+
+		/// \brief Gets the number of entries in the file table.
+		uint8_t getFileTableCount();
+
+		/// \brief Gets the size and length of a file without asking the chip.  The size comes from the listing, the length is known
+		/// once the file has played and its play time has been read.
+		/// \param fileNumber The file number.
+		/// \return Returns the entry, or NULL if the table isn't ready or the file isn't in it.
+		const FileEntry* getFileEntry(uint8_t fileNumber);
+		#endif
 
 		/// \brief Pauses track.
 		/// \return Returns if pausing was successful.
@@ -195,24 +530,352 @@ class VS1000UART
 		/// \return Returns if stopping was successful.
 		bool stopPlay();
 
-		/// \brief Returns the track time.
-		/// \param current Buffer with the current track time.
-		/// \param total Buffer with the total track time.
-		/// \return Returns the current track time.
+		/// \brief Checks if a track is playing.  Costs nothing, the chip is not asked.  Without an activity pin, only plays and stops sent
+		/// by this class are known about, so it can't tell when a track ends.
+		/// \return Returns true when playing and not paused.
+		bool isPlaying();
+
+		#if VS1000PROGRESS
+		/// \brief Returns the track time.  The chip is only asked when the last answer is older than the progress refresh, see
+		/// "setProgressRefresh."  With an activity pin, this returns false right away when nothing is playing.
+		/// \param current Buffer with the current track time in seconds.
+		/// \param total Buffer with the total track time in seconds.
+		/// \return Returns true if the track time is known.
 		bool playTime(uint32_t* current, uint32_t* total);
 
-		/// \brief Returns the track size.
-		/// \param current Buffer with the current track size.
-		/// \param total Buffer with the total track size.
-		/// \return Returns how many bytes are remaining over the total track size.
-		bool fileSize(uint32_t* current, uint32_t* total);
+		/// \brief Returns the track size.  The chip is only asked when the last answer is older than the progress refresh.  In between,
+		/// the bytes remaining are worked out from the byte rate seen between answers.
+		/// \param remaining Buffer with the number of bytes remaining.
+		/// \param total Buffer with the total track size in bytes.
+		/// \return Returns true if the track size is known.
+		bool fileSize(uint32_t* remaining, uint32_t* total);
+		#endif
 
-		void continuousPlayMode();
+		/// \brief Sets the playlist used by continuous play mode.  The array is not copied and must stay valid while playing.
+		/// \param fileNumbers Numbers of the files to play, in order.
+		/// \param count Number of files in the playlist.
+		void setPlaylist(const uint8_t* fileNumbers, uint8_t count);
+
+		/// \brief Sets a function to be called each time continuous play mode starts a track.
+		/// \param callback Function to call, or NULL for none.
+		void setTrackCallback(TrackCallback callback);
+
+		/// \brief Starts playing the playlist.  Returns immediately, "poll" starts each track as soon as the last one ends.  With an
+		/// activity pin, the end of a track is seen on the next "poll."  Without one, the play time is asked for once a second, and more
+		/// often near the end of the track, which leaves a longer gap.  Stopping or playing anything else ends continuous play.
+		/// \param mode Play the list once, loop it, or play it in random order (never the same track twice in a row) until stopped.
+		/// \return Returns false if there is no playlist.
+		bool continuousPlayMode(PLAYLISTMODE mode = PLAYLISTONCE);
+
+		/// \brief Checks if continuous play mode is running.
+		bool isContinuousPlay();
+
+	// Power saving.
+	public:
+		/// \brief Holds the chip in reset, where it draws the least current, until "releaseReset."  Waits for queued commands first,
+		/// stops anything playing, and refuses commands while held.  The volume and the file table are kept for when it is released.
+		void holdReset();
+
+		/// \brief Lets the chip out of reset and waits for it to boot, the same as "reset."  The volume from before the hold is sent
+		/// to the chip, and the file table is reused without listing the files if the chip still has the same number of them.
+		/// \return Returns true if the chip booted.
+		bool releaseReset();
+
+		/// \brief Checks if the chip is being held in reset.
+		bool isHeldInReset();
+
+		/// \brief Checks if the watchdog has found the chip down and is still trying to bring it back.
+		bool isChipDown();
+
+		/// \brief Sleeps the processor until the next interrupt.  A received byte, the activity pin interrupt, or the millis timer wake
+		/// it, so nothing is missed and time outs still work.  Call from "loop" when there is nothing else to do, for example while a
+		/// track plays.  AVR uses idle sleep, ARM waits for an interrupt, ESP32 delays a millisecond so the system can idle.  Deeper
+		/// sleep modes stop the timer and the UART clock, so they are left to the sketch.
+		static void sleep();
+
+	#if VS1000PERSISTENCE
+	// Saving the player state.
+	private:
+		/// \brief What "useStateSnapshot" saves.  The two byte values come last so there is no padding on any board.
+		struct StateSnapshot
+		{
+			uint8_t					version;
+			uint8_t					volume;
+			uint8_t					minimumVolume;
+			uint8_t					maximumVolume;
+			uint8_t					minimumLevel;
+			uint8_t					maximumLevel;
+			uint8_t					fileCount;
+			uint8_t					track;
+			uint8_t					playlistLength;
+			uint8_t					playlistPosition;
+			uint8_t					playlistMode;
+			uint8_t					flags;
+			uint16_t				sequence;
+			uint16_t				fileTableChecksum;
+			uint16_t				playlistChecksum;
+			uint16_t				check;
+		};
+
+	public:
+		/// \brief Saves a snapshot of the player state to memory whenever it changes: the volume, the volume and level limits, what the
+		/// files on the chip were, the last track, and the playlist position.  The snapshot has a version, a sequence number, and a
+		/// CRC.  Each save goes to the next slot, like the volume, so a track change doesn't wear the same bytes every time, and a save
+		/// cut short leaves the one before it.  Saves wait for the volume save delay, and at least a second, so changes close together
+		/// are one save.  Nothing is saved until "restoreState" has been called, so the reset at start up doesn't overwrite the state
+		/// from before it.
+		/// \param memoryAddress Memory address to save the snapshot.
+		/// \param slots Number of 20 byte slots starting at the memory address.  The default is 4.
+		void useStateSnapshot(int memoryAddress, uint8_t slots = 4);
+
+		/// \brief Brings the player back to the newest saved snapshot.  Call after "reset."  The volume limits are applied and the volume
+		/// is sent as one pipelined change.  If something was playing and the chip still has the same files, the track is played again,
+		/// or the playlist picks up at the track it was on if the same playlist has been set.  The firmware can't seek, so the track
+		/// starts from the beginning.  Without an activity pin the end of a track isn't seen, so the last track is played even if it
+		/// had finished.
+		/// \return Returns false if there is no snapshot, or it was cut short or saved by another version.
+		bool restoreState();
+	#endif
+
+	// Asynchronous command engine.  Commands are queued and return immediately, "poll" must be called from "loop" to move them along.
+	private:
+		struct QueuedCommand
+		{
+			COMMAND					command;
+			uint8_t					argument;
+		};
+
+	public:
+		/// \brief Adds a command to the queue.  Use "queuePlayFile" for playing by name.  Commands that haven't been sent yet are merged
+		/// where the result is the same: a newer play replaces a queued one, volume steps and volume changes become one COMMANDSETVOLUME,
+		/// and a command that is already queued is not queued again.  COMMANDSTOP, COMMANDPAUSE, and COMMANDRESUME go ahead of queued
+		/// COMMANDPLAYTIME requests.
+		/// \param command The command to send.
+		/// \param argument The file number for COMMANDPLAYNUMBER, the volume for COMMANDSETVOLUME, otherwise unused.
+		/// \return Returns false if the queue is full.
+		bool queueCommand(COMMAND command, uint8_t argument = 0);
+
+		#if VS1000PLAYBYNAME
+		/// \brief Adds a play by name command to the queue.  The name is copied.  Replaces any play that is still queued.
+		/// \param fileName Track name.
+		/// \return Returns false if the queue is full.
+		bool queuePlayFile(const char* fileName);
+		#endif
+
+		/// \brief Adds a change to a volume level to the queue.  Like other volume changes it is merged with any that haven't been sent,
+		/// so many level changes in a row are sent as one volume change.
+		/// \param level The level, limited to the minimum and maximum levels.
+		/// \return Returns false if the queue is full.
+		bool queueVolumeLevel(VOLUMELEVEL level);
+
+		/// \brief Adds a change of a number of levels from the level the queued commands leave the volume at.  Stops at the minimum and
+		/// maximum levels.
+		/// \param steps Number of levels to go up, or down when negative.
+		/// \return Returns false if the queue is full.
+		bool queueVolumeLevelStep(int8_t steps);
+
+		/// \brief Same as "cycleVolumeLevel," but queued and going from the level the queued commands leave the volume at.
+		/// \return Returns false if the queue is full.
+		bool queueCycleVolumeLevel();
+
+		/// \brief Gets the volume level the volume will be at when the queued commands have completed.
+		VOLUMELEVEL getQueuedVolumeLevel();
+
+		#if VS1000LISTING
+		/// \brief Adds a file listing to the queue.
+		/// \param callback Function called for each file.
+		/// \return Returns false if the queue is full or a listing is already waiting.
+		bool queueListFiles(FileCallback callback);
+		#endif
+
+		/// \brief Checks if a COMMANDPLAYARMED has been sent and is waiting for "triggerArmedPlay."  A COMMANDPLAYARMED is a play by number
+		/// sent without the end of the line, so the chip waits and several boards can be started together.
+		bool isPlayArmed();
+
+		/// \brief Sends the end of the line for an armed play, which starts the track.  The bytes are handed to the hardware right away.
+		/// \return Returns false if no play is armed.
+		bool triggerArmedPlay();
+
+		/// \brief Moves the command engine forward.  Sends the next queued command and parses any response bytes available.  Never blocks.
+		void poll();
+
+		/// \brief Checks if the command engine has finished all its work.
+		/// \return Returns true if no command is active and the queue is empty.
+		bool isIdle();
+
+		/// \brief Gets the status of the active or most recently completed command.
+		COMMANDSTATUS getCommandStatus();
+
+		/// \brief Sets a function to be called each time a queued command completes.
+		/// \param callback Function to call, or NULL for none.
+		void setCommandCallback(CommandCallback callback);
+
+		/// \brief Sets a function to be called for lines from the chip that don't answer a command.  Received bytes are read all the
+		/// time, not only while waiting for an answer.  A boot banner starts the handling of a reset, so a chip that restarted on its
+		/// own gets its volume and file table back.  An answer that comes after its command timed out is recognized as late instead of
+		/// being taken as the answer to the next command, and a late volume still updates the volume.
+		/// \param callback Function to call, or NULL for none.
+		void setEventCallback(EventCallback callback);
+
+		/// \brief Gets how many lines the chip sent that were not the answer to any command.
+		uint16_t getUnsolicitedCount();
+
+		/// \brief Gets the track time read by the most recent successful COMMANDPLAYTIME.
+		/// \param current Buffer for the current track time.
+		/// \param total Buffer for the total track time.
+		void getLastPlayTime(uint32_t* current, uint32_t* total);
+
+		#if VS1000PROGRESS
+		/// \brief Gets the track size read by the most recent successful COMMANDFILESIZE.
+		/// \param remaining Buffer for the number of bytes remaining.
+		/// \param total Buffer for the total track size.
+		void getLastFileSize(uint32_t* remaining, uint32_t* total);
+		#endif
 
 	// Support functions.
 	private:
-		/// \brief Send a command to the audio chip.
-		void sendCommand(const __FlashStringHelper* command);
+		/// \brief Queues a command and blocks until it and any command queued before it have completed.
+		/// \return Returns true if the command was successful.
+		bool runCommand(COMMAND command, uint8_t argument = 0);
+
+		/// \brief Blocks until the command engine is idle.
+		void waitForIdle();
+
+		/// \brief Handles a line that came in while no command was waiting for one, or the boot banner at any time.
+		void processUnsolicitedLine(uint8_t lineLength);
+
+		/// \brief Takes the chip to be down after too many time outs in a row.
+		void markChipDown();
+
+		/// \brief Empties the queue, along with what was waiting on the commands in it.
+		void dropQueuedCommands();
+
+		/// \brief Resets a chip that is down, and reports when it is back.
+		void updateWatchdog();
+
+		/// \brief Takes the next command off the queue and sends it to the chip.
+		void startNextCommand();
+
+		/// \brief Returns a queued command, counting from the front of the queue.
+		QueuedCommand& queuedCommandAt(uint8_t index);
+
+		/// \brief Finds the first queued command that is either of two commands.
+		/// \return Returns the index counting from the front of the queue, or -1 if not queued.
+		int8_t findQueuedCommand(COMMAND command, COMMAND otherCommand = COMMANDNONE);
+
+		/// \brief Works out what the volume will be once the active and queued commands have been sent.
+		uint8_t queuedVolume();
+
+		/// \brief Returns the volume after a command, or the same volume if the command doesn't change it.
+		static uint8_t volumeAfterCommand(uint8_t volume, COMMAND command, uint8_t argument);
+
+		/// \brief Handles a complete line received in response to the active command.
+		/// \param lineLength Number of characters in the line buffer.
+		void processResponseLine(uint8_t lineLength);
+
+		/// \brief Sends as many volume steps as the in flight window allows.
+		void sendVolumeSteps();
+
+		/// \brief Handles a volume echoed back during a COMMANDSETVOLUME.
+		void processVolumeStep();
+
+		/// \brief Updates the play state from the activity pin.
+		void updateActivity();
+
+		#if VS1000PROGRESS
+		/// \brief Gets how long the track has played since a progress answer.
+		/// \param sampleTime When the answer was received.
+		uint32_t progressElapsed(unsigned long sampleTime);
+
+		/// \brief Gets the track time in milliseconds moved along from the last answer.
+		uint32_t interpolatedPosition();
+
+		/// \brief Gets the bytes remaining moved along from the last answer.
+		uint32_t interpolatedRemainingBytes();
+		#endif
+
+		/// \brief Starts the next track of the playlist or checks if the current one has ended.
+		void updatePlaylist();
+
+		/// \brief Returns the playlist position after the current one, or the playlist length when done.
+		uint8_t nextPlaylistPosition();
+
+		/// \brief Interrupt handlers for the activity pin.  There is one per instance that can use an interrupt.
+		static void activityInterrupt0();
+		static void activityInterrupt1();
+		static void activityInterrupt2();
+		static void activityInterrupt3();
+
+		/// \brief Handles a boot message received during a COMMANDRESET.
+		void processBootLine();
+
+		#if VS1000LISTING
+		/// \brief Handles a file received during a COMMANDLISTFILES.
+		/// \param lineLength Number of characters in the line buffer.
+		void processListLine(uint8_t lineLength);
+
+		/// \brief Calculates the 16 bit hash of an 11 character file name.
+		static uint16_t hashFileName(const char* fileName);
+
+		/// \brief Compares two 11 character file names, a shorter name is taken as padded with spaces the same as for the hash.
+		static bool sameFileName(const char* fileName1, const char* fileName2);
+
+		#if VS1000PLAYBYNAME
+		/// \brief Checks the file in the answer to a play looked up in the file table is the one asked for.  If it isn't, the name is
+		/// sent and the active command becomes a COMMANDPLAYNAME.
+		/// \return Returns true if it is the right file.
+		bool checkPlayedName();
+		#endif
+
+		/// \brief Queues filling the file table, or reads it from memory if the saved copy matches the chip.
+		void loadFileTable();
+
+		#if VS1000PERSISTENCE
+		/// \brief Saves the file table to memory.
+		void saveFileTable();
+		#endif
+
+		/// \brief Calculates the check value of the file table.  Only the names and sizes are checked, they are what says if the table
+		/// is current.
+		uint16_t fileTableChecksum();
+
+		/// \brief Stores the length from the last play time answer in the file table entry of the last track played.
+		void rememberTrackLength();
+		#endif
+
+		/// \brief Holds the reset pin low and starts waiting for the boot messages.
+		void startReset();
+
+		/// \brief Moves the connection to the next baud rate to probe and resets the chip again.
+		/// \return Returns false if every rate has been tried.
+		bool probeNextBaudRate();
+
+		/// \brief Gets the kind of time out used for a command.
+		static TIMEOUTCLASS timeoutClassOf(COMMAND command);
+
+		/// \brief Adds the time a command took to be answered to the tracking of adaptive time outs.
+		/// \param timeoutClass Kind of command.
+		/// \param responseTime Time in milliseconds.
+		void recordResponseTime(TIMEOUTCLASS timeoutClass, unsigned long responseTime);
+
+		/// \brief Sends the new line that works around the firmware play time bug, then waits for one more line.
+		void sendPlayTimeWorkaround();
+
+		/// \brief Finishes the active command and reports it.
+		void completeCommand(COMMANDSTATUS status);
+
+		/// \brief Adds a received byte to the line being parsed.
+		/// \return Returns true when a complete line is in the tokenizer.
+		bool readLineByte(char character);
+
+		/// \brief Buffers text from flash memory to send to the chip.
+		void sendText(const __FlashStringHelper* text);
+
+		/// \brief Buffers a command character followed by text, and the end of the line, as one frame to send to the chip.
+		/// \param command The command character.
+		/// \param text The rest of the command, e.g. the file number or name.
+		/// \param endLine False to leave off the end of the line.
+		void sendFrame(char command, const char* text, bool endLine);
 
 		/// \brief Read the response back from the audio chip and check it against the expected command.
 		bool checkCommandResult(char command);
@@ -220,48 +883,258 @@ class VS1000UART
 		/// \brief Converts a volume to a volume level.
 		VOLUMELEVEL calculateLevelFromVolume(uint8_t volume);
 
-		/// \brief Synchs the volume on the chip and the class's stored volume.
-		void synchVolumes();
+		/// \brief Queues the commands that synch the volume on the chip and the class's stored volume.
+		/// \param booted True when the chip has just booted, so its volume is the boot volume and doesn't have to be asked for.
+		void synchVolumes(bool booted);
+
+		/// \brief Gets the level after a level in the cycle of "cycleVolumeLevel."
+		VOLUMELEVEL nextCycleLevel(VOLUMELEVEL level);
 
-		/// \brief Reads a line from the stream.
-		/// \return The number of characters placed in the buffer (0 means no valid data found).
-		int readLine();
+		/// \brief Converts a volume level to a volume.  The level is limited to the minimum and maximum levels.
+		uint8_t calculateVolumeFromLevel(VOLUMELEVEL level);
+
+		/// \brief Fills in the table of volumes for each level from the volume and level settings.
+		void buildLevelTable();
+
+		/// \brief Integer division rounded to the nearest whole number.
+		static int16_t roundedDivide(int32_t numerator, int16_t denominator);
 
 		/// \brief Raises the volume without saving the value.
-		/// \return Returns the current volume.
-		void volumeUpWithoutSaving();
+		/// \return Returns true if the chip reported the new volume.
+		bool volumeUpWithoutSaving();
 
 		/// \brief Lowers the volume without saving the value.
-		/// \return Returns the current volume.
-		void volumeDownWithoutSaving();
+		/// \return Returns true if the chip reported the new volume.
+		bool volumeDownWithoutSaving();
 
-		/// \brief Read the volume level from the chip.
-		void readVolumeFromChip();
+		/// \brief Read the volume level from the line buffer.
+		/// \return Returns true if the line buffer contained a volume.
+		bool readVolumeFromChip();
 
-		/// \brief Stores the volume.
+		#if VS1000PERSISTENCE
+		/// \brief Stores the volume, or starts the save delay.
 		void saveVolumeToMemory();
 
+		/// \brief Writes the volume to the next memory slot.
+		void commitVolumeToMemory();
+
+		/// \brief Starts the save delay of the player state, or saves it.
+		void markStateDirty();
+
+		/// \brief Writes the player state snapshot to memory.
+		void commitState();
+
+		/// \brief Calculates the CRC-16 (CCITT) of some bytes.
+		static uint16_t stateChecksum(const uint8_t* bytes, uint8_t length);
+
+		/// \brief Finds the newest memory slot and reads the volume from it.
+		/// \param volume Buffer for the volume.
+		/// \return Returns false if no valid volume has been saved.
+		bool readVolumeFromMemory(uint8_t* volume);
+		#endif
+
 	private:
 		// Constant parameters for configuration.  Encapsulate variables to prevent name conflict.
-		static const uint8_t		_lineBufferSize;
+		static const uint8_t		_defaultLineBufferSize;
 		static const uint8_t		_chipMinVolume;
 		static const uint8_t		_chipMaxVolume;
+		static const uint16_t		_defaultTimeouts[TIMEOUTCOUNT];
+		static const uint8_t		_minimumAdaptiveTimeout;
+		static const uint8_t		_lateAnswerTime;
+		static const uint8_t		_chipVolumeStep;
+		static const uint8_t		_volumeStepWindow;
+		static const uint8_t		_resetHoldTime;
+		static const uint8_t		_volumeNotSaved;
+		static const uint8_t		_activityStartTime;
+		static const uint16_t		_playlistCheckInterval;
+		static const uint8_t		_playlistEndCheckInterval;
+		static const uint8_t		_playlistNotStarted;
+		static const uint16_t		_recoveryInterval;
+		#if VS1000PERSISTENCE
+		static const uint8_t		_savedFileEntrySize;
+		static const uint8_t		_stateVersion;
+		static const uint16_t		_minimumStateSaveDelay;
+		static const uint8_t		_statePlaying;
+		static const uint8_t		_statePaused;
+		static const uint8_t		_statePlaylist;
+		#endif
+		static const uint8_t		_activityInterruptCount = 4;
+		static const uint8_t		_probeBaudRateCount = 5;
+		static const uint32_t		_probeBaudRates[_probeBaudRateCount];
+		static VS1000UART*			_activityInstances[_activityInterruptCount];
 
-		// Stream for the chip/board, e.g. SoftwareSerial or Serial1.
-		Stream*						_chipStream;
+		// Connection to the chip/board, e.g. SoftwareSerial or Serial1.
+		VS1000Transport*			_transport;
+		bool						_ownsTransport;
 
 		int8_t						_resetPin;
 		char*						_lineBuffer;
+		bool						_ownsLineBuffer;
+		#if VS1000PERSISTENCE
+		VS1000Storage*				_storage;
+		#endif
+		#if VS1000DEBUG
+		DebugOutput					_debugOutput;
+		#endif
 
 		// Volume.
 		uint8_t						_minimumVolume;
 		uint8_t						_maximumVolume;
-		float						_volumeIncrement;
+		uint8_t						_levelVolumes[VOLUME10 + 1];
+		const uint8_t*				_volumeCurve;
 		VOLUMELEVEL					_minimumLevel;
 		VOLUMELEVEL					_maximumLevel;
+		uint8_t						_volume;
+
+		#if VS1000PERSISTENCE
+		// Saving the volume.
 		bool						_persistentVolume;
 		int							_memoryAddress;
-		uint8_t						_volume;
+		unsigned int				_volumeSaveDelay;
+		unsigned long				_volumeChangeTime;
+		bool						_volumeDirty;
+		uint8_t						_volumeMemorySlots;
+		uint8_t						_volumeSlot;
+		uint8_t						_volumeSequence;
+		uint8_t						_savedVolume;
+
+		// Saving the player state.
+		int							_stateAddress;
+		uint8_t						_stateSlots;
+		uint8_t						_stateSlot;
+		uint16_t					_stateSequence;
+		bool						_stateRestored;
+		bool						_stateDirty;
+		unsigned long				_stateChangeTime;
+		#endif
+
+		// Command engine.  The queue is a ring buffer.
+		QueuedCommand				_commandQueue[VS1000COMMANDQUEUESIZE];
+		uint8_t						_commandQueueStart;
+		uint8_t						_commandQueueCount;
+		COMMAND						_activeCommand;
+		uint8_t						_activeArgument;
+		COMMANDSTATUS				_commandStatus;
+		unsigned long				_commandStartTime;
+		bool						_workaroundSent;
+		bool						_playArmed;
+		#if VS1000STATISTICS
+		VS1000Statistics*			_statistics;
+		unsigned long				_commandStartMicros;
+		#endif
+		VS1000Tokenizer				_tokenizer;
+		#if VS1000PLAYBYNAME
+		char						_queuedFileName[12];
+		#if VS1000LISTING
+		bool						_playLookedUp;
+		bool						_checkPlayName;
+		#endif
+		#endif
+		CommandCallback				_commandCallback;
+
+		// Lines that don't answer the active command.
+		EventCallback				_eventCallback;
+		COMMAND						_lateCommand;
+		unsigned long				_lateTime;
+		unsigned long				_receiveTime;
+		uint16_t					_unsolicitedCount;
+		uint8_t						_unsolicitedBytes;
+
+		uint32_t					_currentTime;
+		uint32_t					_totalTime;
+		#if VS1000PROGRESS
+		uint32_t					_remainingBytes;
+		uint32_t					_totalBytes;
+		#endif
+
+		// Time outs.  The adaptive average is kept times 8 and the deviation times 4 so they can be updated with shifts.  An average of
+		// 0 means nothing has been measured yet.
+		uint16_t					_timeouts[TIMEOUTCOUNT];
+		bool						_adaptiveTimeouts;
+		uint16_t					_averageResponse[TIMEOUTCOUNT];
+		uint16_t					_responseDeviation[TIMEOUTCOUNT];
+
+		#if VS1000PROGRESS
+		// Progress cache.
+		unsigned int				_progressRefresh;
+		bool						_progressValid;
+		unsigned long				_progressTime;
+		uint32_t					_progressPosition;
+		bool						_sizeValid;
+		unsigned long				_sizeTime;
+		uint32_t					_byteRate;
+		#endif
+
+		// Pipelined volume setting.
+		uint8_t						_volumeStepsToSend;
+		uint8_t						_volumeStepsInFlight;
+		uint8_t						_pipelineVolume;
+		uint8_t						_pipelineStartVolume;
+
+		// Reset.
+		unsigned int				_resetTimeout;
+		int16_t						_bootVolume;
+		bool						_resetHolding;
+		bool						_bootBannerFound;
+		uint8_t						_bootLineCount;
+		unsigned long				_bootTime;
+		int16_t						_bootFileCount;
+
+		// Power saving.
+		bool						_powerSaving;
+		bool						_heldInReset;
+		uint8_t						_heldVolume;
+		bool						_baudProbing;
+		uint8_t						_watchdogTimeouts;
+		uint8_t						_consecutiveTimeouts;
+		bool						_chipDown;
+		bool						_recovering;
+		unsigned long				_recoveryTime;
+		uint8_t						_baudAttempt;
+		unsigned long				_probeStartRate;
+
+		#if VS1000LISTING
+		// File table.  Kept through holding the chip in reset or the watchdog bringing it back.
+		FileEntry*					_fileTable;
+		uint8_t						_fileTableCapacity;
+		uint8_t						_fileTableCount;
+		bool						_fileTableReady;
+		bool						_fileTableKept;
+		bool						_trackLengthWanted;
+		#if VS1000PERSISTENCE
+		int							_fileTableAddress;
+		#endif
+		uint8_t						_listedFileCount;
+
+		// Destinations for a file listing.
+		FileCallback				_fileCallback;
+		bool						_fileCallbackStopped;
+		char						(*_listFileNames)[12];
+		uint32_t*					_listFileSizes;
+		uint8_t						_listArrayLength;
+		#endif
+
+		// Play state.
+		int8_t						_activityPin;
+		bool						_activityInterrupt;
+		volatile bool				_activityChanged;
+		bool						_playing;
+		bool						_paused;
+		unsigned long				_playStartTime;
+		uint8_t						_lastTrack;
+		TrackEndCallback			_trackEndCallback;
+
+		// Continuous play mode.
+		const uint8_t*				_playlist;
+		uint8_t						_playlistLength;
+		uint8_t						_playlistPosition;
+		PLAYLISTMODE				_playlistMode;
+		bool						_playlistActive;
+		bool						_playlistNext;
+		bool						_playlistAdvancing;
+		unsigned long				_playlistCheckTime;
+		uint16_t					_playlistCheckDelay;
+		TrackCallback				_trackCallback;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+/*! @file VS1000UARTStatic.h */
+
+#ifndef VS1000UARTSTATIC_H
+#define VS1000UARTSTATIC_H
+
+#include "VS1000UART.h"
+#include "VS1000EEPROMStorage.h"
+
+/// \brief VS1000UART configured at compile time.  The line buffer is part of the object, so nothing is allocated on the heap, and the
+/// printing for debugging output is only built in when it is turned on.
+///
+/// The template can't take code out of VS1000UART, which is compiled once for every instance.  PERSISTENCE only picks the constructor
+/// and the storage: an instance without it still has the members for saving and the saving code is still linked.  To leave them out,
+/// build with VS1000PERSISTENCE set to 0, and VS1000DEBUG to leave out the debugging messages, see "VS1000Config.h."
+///
+/// \tparam BUFFERSIZE Size of the line buffer.  The longest line the chip sends is a file listing, which needs 22 characters and the terminator.
+/// \tparam PERSISTENCE If true, the volume is saved to EEPROM and the constructor takes the memory address.  Needs VS1000PERSISTENCE.
+/// \tparam DEBUGLEVEL Debugging output to the serial monitor.  Set the value to specify the amount of messages.
+/// 0 - No messages.
+/// 1 - Basic messages (boot up).
+/// 2 - Additional messages (line buffer).
+template <uint8_t BUFFERSIZE = 23, bool PERSISTENCE = false, uint8_t DEBUGLEVEL = 0>
+class VS1000UARTStatic : public VS1000UART
+{
+	static_assert(BUFFERSIZE >= 23, "The line buffer must hold at least 23 characters.");
+	static_assert(VS1000PERSISTENCE || !PERSISTENCE, "Persistence isn't built in, see VS1000PERSISTENCE.");
+
+	// Constructors.
+	public:
+		/// \brief Constructor for use without persistence.
+		/// \param chipStream Pointer to the serial stream used to communicate with the chip.
+		/// \param resetPin Reset pin.
+		VS1000UARTStatic(Stream* chipStream, int8_t resetPin) :
+			VS1000UART(&_streamTransport, resetPin, _staticLineBuffer, BUFFERSIZE, NULL, -1, debugOutput()),
+			_streamTransport(chipStream)
+		{
+			static_assert(!PERSISTENCE, "Persistence needs a memory address.");
+		}
+
+		#if VS1000PERSISTENCE
+		/// \brief Constructor for use with persistence.
+		/// \param chipStream Pointer to the serial stream used to communicate with the chip.
+		/// \param resetPin Reset pin.
+		/// \param memoryAddress Memory address to save volume level.
+		VS1000UARTStatic(Stream* chipStream, int8_t resetPin, int memoryAddress) :
+			VS1000UART(&_streamTransport, resetPin, _staticLineBuffer, BUFFERSIZE, &VS1000EEPROM, memoryAddress, debugOutput()),
+			_streamTransport(chipStream)
+		{
+			static_assert(PERSISTENCE, "Persistence is turned off, remove the memory address.");
+		}
+		#endif
+
+	// Support functions.
+	private:
+		/// \brief Gets the debugging output function, or NULL when debugging is off so the printing code is never built.  Without
+		/// VS1000DEBUG the function is never called.
+		static DebugOutput debugOutput()
+		{
+			return DEBUGLEVEL > 0 ? printDebugOutput : NULL;
+		}
+
+		/// \brief Prints a debugging message if it is within the debugging level.
+		static void printDebugOutput(uint8_t level, const __FlashStringHelper* label, const char* text)
+		{
+			if (level <= DEBUGLEVEL)
+			{
+				Serial.print(label);
+				Serial.println(text);
+			}
+		}
+
+	private:
+		// The base class only keeps a pointer to the transport, it isn't used until after construction.
+		VS1000StreamTransport		_streamTransport;
+		char						_staticLineBuffer[BUFFERSIZE];
+};
+
+#endif